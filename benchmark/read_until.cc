@@ -0,0 +1,116 @@
+#include <algorithm>
+#include <chrono>
+#include <coroutine>
+#include <format>
+#include <iostream>
+#include <span>
+#include <string>
+
+import xyco.runtime;
+import xyco.task;
+import xyco.io;
+
+// Compares delimiter scanning with `std::find` and `io::find_byte`, and
+// reading lines from an in-memory reader with the copying `read_line` and
+// with `read_until_view`. The first argument sets the line length.
+
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t INPUT_SIZE = 64 * 1024 * 1024;
+constexpr size_t DEFAULT_LINE_LENGTH = 80;
+
+// Serves `content` without any IO, so only the buffering and scanning are
+// measured.
+class MemoryReader {
+ public:
+  auto read(std::string::iterator begin,
+            std::string::iterator end) -> xyco::runtime::Future<xyco::utils::Result<uintptr_t>> {
+    auto len = std::min(static_cast<size_t>(std::distance(begin, end)), content_.size() - pos_);
+    std::copy_n(content_.begin() + static_cast<std::string::difference_type>(pos_), len, begin);
+    pos_ += len;
+    co_return len;
+  }
+
+  explicit MemoryReader(const std::string &content) : content_(content) {}
+
+ private:
+  const std::string &content_;
+  size_t pos_{};
+};
+
+using Reader = xyco::io::BufferReader<MemoryReader, std::string>;
+
+template <typename F>
+auto measure(std::string_view name, F f) -> void {
+  auto start = Clock::now();
+  auto lines = f();
+  auto seconds = std::chrono::duration<double>(Clock::now() - start).count();
+  std::cout << std::format("{:<16} lines: {} throughput: {:.2f}GB/s\n",
+                           name,
+                           lines,
+                           static_cast<double>(INPUT_SIZE) / seconds / 1e9);
+}
+
+template <typename Find>
+auto count_lines(const std::string &content, Find find) -> size_t {
+  size_t lines = 0;
+  for (auto begin = content.begin(); begin != content.end(); lines++) {
+    begin = find(begin, content.end());
+    if (begin != content.end()) {
+      begin++;
+    }
+  }
+  return lines;
+}
+
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-reference-coroutine-parameters)
+auto read_lines(const std::string &content) -> xyco::runtime::Future<size_t> {
+  MemoryReader memory_reader(content);
+  Reader reader(&memory_reader);
+  size_t lines = 0;
+  while (!(*co_await xyco::io::BufferReadExt::read_line<Reader, std::string>(reader)).empty()) {
+    lines++;
+  }
+  co_return lines;
+}
+
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-reference-coroutine-parameters)
+auto read_line_views(const std::string &content) -> xyco::runtime::Future<size_t> {
+  MemoryReader memory_reader(content);
+  Reader reader(&memory_reader);
+  size_t lines = 0;
+  while (true) {
+    auto [begin, end] =
+        *co_await xyco::io::BufferReadExt::read_until_view<Reader, std::string>(reader, '\n');
+    if (begin == end) {
+      co_return lines;
+    }
+    lines++;
+  }
+}
+
+// NOLINTNEXTLINE(bugprone-exception-escape)
+auto main(int argc, char *argv[]) -> int {
+  auto line_length = argc > 1 ? std::stoul(std::span(argv, argc)[1]) : DEFAULT_LINE_LENGTH;
+
+  std::string content(INPUT_SIZE, 'x');
+  for (auto pos = line_length - 1; pos < content.size(); pos += line_length) {
+    content[pos] = '\n';
+  }
+
+  auto runtime = *xyco::runtime::Builder::new_multi_thread()
+                      .worker_threads(1)
+                      .registry<xyco::task::BlockingRegistry>(1)
+                      .registry<xyco::io::IoRegistry>(4)
+                      .build();
+
+  measure("std::find", [&]() {
+    return count_lines(content, [](auto begin, auto end) { return std::find(begin, end, '\n'); });
+  });
+  measure("find_byte", [&]() {
+    return count_lines(
+        content, [](auto begin, auto end) { return xyco::io::find_byte(begin, end, '\n'); });
+  });
+  measure("read_line", [&]() { return runtime->block_on(read_lines(content)); });
+  measure("read_until_view", [&]() { return runtime->block_on(read_line_views(content)); });
+}
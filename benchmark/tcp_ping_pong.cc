@@ -0,0 +1,117 @@
+#include <algorithm>
+#include <chrono>
+#include <coroutine>
+#include <format>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <vector>
+
+import xyco.runtime;
+import xyco.task;
+import xyco.io;
+import xyco.net;
+
+// Measures the round trip time of small messages over loopback TCP. Passing a
+// busy poll budget in microseconds as the first argument enables
+// `SO_BUSY_POLL` on both streams and spinning in `IoRegistry::select`.
+
+using Clock = std::chrono::steady_clock;
+
+constexpr uint16_t PORT = 8090;
+constexpr int MESSAGE_SIZE = 64;
+
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-reference-coroutine-parameters)
+auto read_exact(xyco::net::TcpStream &stream, std::string &buffer) -> xyco::runtime::Future<bool> {
+  auto begin = buffer.begin();
+  while (begin != buffer.end()) {
+    auto nbytes = co_await stream.read(begin, buffer.end());
+    if (!nbytes || *nbytes == 0) {
+      co_return false;
+    }
+    begin += static_cast<std::string::difference_type>(*nbytes);
+  }
+  co_return true;
+}
+
+auto enable_busy_poll(xyco::net::TcpStream &stream, std::chrono::microseconds budget) -> void {
+  if (budget.count() == 0) {
+    return;
+  }
+  auto result = stream.set_busy_poll(budget);
+  if (!result) {
+    std::cerr << std::format("SO_BUSY_POLL unavailable: {}\n", result.error().info_);
+  }
+}
+
+auto pong(xyco::net::TcpListener listener, std::chrono::microseconds busy_poll)
+    -> xyco::runtime::Future<void> {
+  auto stream = std::move((co_await listener.accept())->first);
+  enable_busy_poll(stream, busy_poll);
+
+  std::string buffer(MESSAGE_SIZE, 0);
+  while (co_await read_exact(stream, buffer)) {
+    *co_await xyco::io::WriteExt::write_all(stream, buffer);
+  }
+}
+
+auto ping(int iterations, std::chrono::microseconds busy_poll)
+    -> xyco::runtime::Future<std::vector<Clock::duration>> {
+  auto stream =
+      *co_await xyco::net::TcpStream::connect(xyco::net::SocketAddr::new_v4("127.0.0.1", PORT));
+  enable_busy_poll(stream, busy_poll);
+
+  std::vector<Clock::duration> latencies;
+  latencies.reserve(iterations);
+  std::string buffer(MESSAGE_SIZE, 'x');
+  for (int i = 0; i < iterations; i++) {
+    auto sent_at = Clock::now();
+    *co_await xyco::io::WriteExt::write_all(stream, buffer);
+    co_await read_exact(stream, buffer);
+    latencies.push_back(Clock::now() - sent_at);
+  }
+
+  co_return latencies;
+}
+
+auto bind() -> xyco::runtime::Future<xyco::net::TcpListener> {
+  auto tcp_socket = *xyco::net::TcpSocket::new_v4();
+  *tcp_socket.set_reuseaddr(true);
+  *co_await tcp_socket.bind(xyco::net::SocketAddr::new_v4({}, PORT));
+  co_return *co_await tcp_socket.listen(1);
+}
+
+// NOLINTNEXTLINE(bugprone-exception-escape)
+auto main(int argc, char *argv[]) -> int {
+  constexpr int iterations = 100000;
+  constexpr int percentile_base = 100;
+  constexpr int p99 = 99;
+
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  auto busy_poll = std::chrono::microseconds(argc > 1 ? std::stoi(argv[1]) : 0);
+
+  auto runtime = *xyco::runtime::Builder::new_multi_thread()
+                      .worker_threads(2)
+                      .registry<xyco::task::BlockingRegistry>(1)
+                      .registry<xyco::io::LocalIoRegistry>(4, busy_poll)
+                      .build();
+
+  auto listener = runtime->block_on(bind());
+  runtime->spawn(pong(std::move(listener), busy_poll));
+  auto latencies = runtime->block_on(ping(iterations, busy_poll));
+
+  std::ranges::sort(latencies);
+  auto to_us = [](Clock::duration duration) {
+    return std::chrono::duration_cast<std::chrono::duration<double, std::micro>>(duration).count();
+  };
+  std::cout << std::format(
+      "busy poll: {}us\niterations: {}\nmean: {:.2f}us\np50: {:.2f}us\np99: {:.2f}us\n"
+      "max: {:.2f}us\n",
+      busy_poll.count(),
+      latencies.size(),
+      to_us(std::accumulate(latencies.begin(), latencies.end(), Clock::duration{}) /
+            static_cast<Clock::rep>(latencies.size())),
+      to_us(latencies[latencies.size() / 2]),
+      to_us(latencies[latencies.size() * p99 / percentile_base]),
+      to_us(latencies.back()));
+}
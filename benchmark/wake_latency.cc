@@ -0,0 +1,75 @@
+#include <algorithm>
+#include <chrono>
+#include <coroutine>
+#include <format>
+#include <iostream>
+#include <numeric>
+#include <vector>
+
+import xyco.runtime;
+import xyco.sync;
+import xyco.task;
+import xyco.io;
+
+// Measures how long a future stays queued after being woken by a task on
+// another worker. Two tasks ping-pong timestamps through bounded channels, so
+// every hop parks one side until its peer sends.
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int CHANNEL_SIZE = 1;
+
+using Sender = xyco::sync::mpsc::Sender<Clock::time_point, CHANNEL_SIZE>;
+using Receiver = xyco::sync::mpsc::Receiver<Clock::time_point, CHANNEL_SIZE>;
+
+auto pong(Receiver ping_receiver, Sender pong_sender) -> xyco::runtime::Future<void> {
+  while (auto sent_at = co_await ping_receiver.receive()) {
+    co_await pong_sender.send(*sent_at);
+  }
+}
+
+auto ping(Sender ping_sender, Receiver pong_receiver, int iterations)
+    -> xyco::runtime::Future<std::vector<Clock::duration>> {
+  std::vector<Clock::duration> latencies;
+  latencies.reserve(iterations);
+  for (int i = 0; i < iterations; i++) {
+    co_await ping_sender.send(Clock::now());
+    auto sent_at = *co_await pong_receiver.receive();
+    // A round trip contains two wakeups.
+    latencies.push_back((Clock::now() - sent_at) / 2);
+  }
+
+  co_return latencies;
+}
+
+// NOLINTNEXTLINE(bugprone-exception-escape)
+auto main() -> int {
+  constexpr int iterations = 10000;
+  constexpr int percentile_base = 100;
+  constexpr int p99 = 99;
+
+  auto runtime = *xyco::runtime::Builder::new_multi_thread()
+                      .worker_threads(2)
+                      .registry<xyco::task::BlockingRegistry>(1)
+                      .registry<xyco::io::IoRegistry>(4)
+                      .build();
+
+  auto [ping_sender, ping_receiver] = xyco::sync::mpsc::channel<Clock::time_point, CHANNEL_SIZE>();
+  auto [pong_sender, pong_receiver] = xyco::sync::mpsc::channel<Clock::time_point, CHANNEL_SIZE>();
+  runtime->spawn(pong(std::move(ping_receiver), std::move(pong_sender)));
+  auto latencies =
+      runtime->block_on(ping(std::move(ping_sender), std::move(pong_receiver), iterations));
+
+  std::ranges::sort(latencies);
+  auto to_us = [](Clock::duration duration) {
+    return std::chrono::duration_cast<std::chrono::duration<double, std::micro>>(duration).count();
+  };
+  std::cout << std::format(
+      "iterations: {}\nmean: {:.2f}us\np50: {:.2f}us\np99: {:.2f}us\nmax: {:.2f}us\n",
+      latencies.size(),
+      to_us(std::accumulate(latencies.begin(), latencies.end(), Clock::duration{}) /
+            static_cast<Clock::rep>(latencies.size())),
+      to_us(latencies[latencies.size() / 2]),
+      to_us(latencies[latencies.size() * p99 / percentile_base]),
+      to_us(latencies.back()));
+}
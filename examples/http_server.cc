@@ -1,3 +1,6 @@
+#include <sys/uio.h>
+
+#include <array>
 #include <charconv>
 #include <coroutine>
 #include <sstream>
@@ -155,42 +158,40 @@ class Server {
         status_line.code_ = SUCCESS_CODE;
         status_line.reason_ = "OK";
       }
-      *co_await xyco::io::WriteExt::write_all(server_stream, status_line.to_string());
 
       if (!open_file_result) {
-        std::string body = "<P>Your browser sent a bad request.\r\n";
-        *co_await xyco::io::WriteExt::write_all(
-            server_stream,
-            "Content-Length: " + std::to_string(body.size()) + "\r\n");
-        *co_await xyco::io::WriteExt::write_all(server_stream, "\r\n");
-        *co_await xyco::io::WriteExt::write_all(server_stream, body);
+        co_await write_response(server_stream,
+                                status_line,
+                                "<P>Your browser sent a bad request.\r\n");
         co_return;
       }
       auto file = *std::move(open_file_result);
+      auto file_size = *co_await file.size();
       *co_await xyco::io::WriteExt::write_all(
           server_stream,
-          "Content-Length: " + std::to_string(*co_await file.size()) + "\r\n");
-      *co_await xyco::io::WriteExt::write_all(server_stream, "\r\n");
-      auto reader = xyco::io::BufferReader<xyco::fs::File, std::string>(&file);
-      std::string line = "a";
-      while (!line.empty()) {
-        line = *co_await xyco::io::BufferReadExt::read_line<decltype(reader), std::string>(reader);
-        *co_await xyco::io::WriteExt::write_all(server_stream, line);
-      }
+          status_line.to_string() + "Content-Length: " + std::to_string(file_size) + "\r\n\r\n");
+      *co_await xyco::io::copy_file_to_stream(file, server_stream, 0, file_size);
     } else {
       status_line.code_ = SERVER_ERROR_CODE;
       status_line.reason_ = "Internal Server Error";
-      *co_await xyco::io::WriteExt::write_all(server_stream, status_line.to_string());
-
-      std::string body = "<P>Unsupported method.\r\n";
-      *co_await xyco::io::WriteExt::write_all(
-          server_stream,
-          "Content-Length: " + std::to_string(body.size()) + "\r\n");
-      *co_await xyco::io::WriteExt::write_all(server_stream, "\r\n");
-      *co_await xyco::io::WriteExt::write_all(server_stream, body);
+      co_await write_response(server_stream, status_line, "<P>Unsupported method.\r\n");
     }
   }
 
+  // Sends the status line, headers and body with one gathered write.
+  static auto write_response(
+      // NOLINTNEXTLINE(cppcoreguidelines-avoid-reference-coroutine-parameters)
+      xyco::net::TcpStream &server_stream,
+      // NOLINTNEXTLINE(cppcoreguidelines-avoid-reference-coroutine-parameters)
+      const StatusLine &status_line,
+      std::string body) -> xyco::runtime::Future<void> {
+    auto head =
+        status_line.to_string() + "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n";
+    auto iovecs = std::array{iovec{.iov_base = head.data(), .iov_len = head.size()},
+                             iovec{.iov_base = body.data(), .iov_len = body.size()}};
+    *co_await xyco::io::WriteExt::write_all_vectored(server_stream, iovecs);
+  }
+
   std::unique_ptr<xyco::runtime::Runtime> runtime_;
   int port_;
 
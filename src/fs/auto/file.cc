@@ -0,0 +1,122 @@
+module;
+
+#include <expected>
+#include <filesystem>
+#include <span>
+#include <variant>
+
+module xyco.fs;
+
+// Takes `options` by value since the future returned by `open` refers to it.
+template <typename Options>
+auto open_with(Options options, std::filesystem::path path)
+    -> xyco::runtime::Future<xyco::utils::Result<xyco::fs::File>> {
+  co_return (co_await options.open(std::move(path))).transform([](auto file) {
+    return xyco::fs::File(std::move(file));
+  });
+}
+
+auto xyco::fs::File::create(std::filesystem::path path) -> runtime::Future<utils::Result<File>> {
+  co_return co_await OpenOptions().write(true).create(true).truncate(true).open(std::move(path));
+}
+
+auto xyco::fs::File::open(std::filesystem::path path) -> runtime::Future<utils::Result<File>> {
+  co_return co_await OpenOptions().read(true).open(std::move(path));
+}
+
+auto xyco::fs::File::metadata() const -> runtime::Future<utils::Result<Metadata>> {
+  return std::visit([](const auto &file) { return file.metadata(); }, file_);
+}
+
+auto xyco::fs::File::refresh_metadata() const -> runtime::Future<utils::Result<Metadata>> {
+  return std::visit([](const auto &file) { return file.refresh_metadata(); }, file_);
+}
+
+auto xyco::fs::File::size() const -> runtime::Future<utils::Result<uintmax_t>> {
+  return std::visit([](const auto &file) { return file.size(); }, file_);
+}
+
+auto xyco::fs::File::status() -> runtime::Future<utils::Result<std::filesystem::file_status>> {
+  return std::visit([](auto &file) { return file.status(); }, file_);
+}
+
+auto xyco::fs::File::set_permissions(std::filesystem::perms prms,
+                                     std::filesystem::perm_options opts)
+    -> runtime::Future<utils::Result<void>> {
+  return std::visit([&](auto &file) { return file.set_permissions(prms, opts); }, file_);
+}
+
+auto xyco::fs::File::modified() const -> runtime::Future<utils::Result<timespec>> {
+  return std::visit([](const auto &file) { return file.modified(); }, file_);
+}
+
+auto xyco::fs::File::accessed() const -> runtime::Future<utils::Result<timespec>> {
+  return std::visit([](const auto &file) { return file.accessed(); }, file_);
+}
+
+auto xyco::fs::File::created() const -> runtime::Future<utils::Result<timespec>> {
+  return std::visit([](const auto &file) { return file.created(); }, file_);
+}
+
+auto xyco::fs::File::read_vectored(std::span<const xyco::libc::iovec> iovecs)
+    -> runtime::Future<utils::Result<uintptr_t>> {
+  return std::visit([&](auto &file) { return file.read_vectored(iovecs); }, file_);
+}
+
+auto xyco::fs::File::write_vectored(std::span<const xyco::libc::iovec> iovecs)
+    -> runtime::Future<utils::Result<uintptr_t>> {
+  return std::visit([&](auto &file) { return file.write_vectored(iovecs); }, file_);
+}
+
+auto xyco::fs::File::flush() const -> runtime::Future<utils::Result<void>> {
+  return std::visit([](const auto &file) { return file.flush(); }, file_);
+}
+
+auto xyco::fs::File::allocate(xyco::libc::off64_t offset, xyco::libc::off64_t len, int mode)
+    -> runtime::Future<utils::Result<void>> {
+  return std::visit([&](auto &file) { return file.allocate(offset, len, mode); }, file_);
+}
+
+auto xyco::fs::File::sync_data() const -> runtime::Future<utils::Result<void>> {
+  return std::visit([](const auto &file) { return file.sync_data(); }, file_);
+}
+
+auto xyco::fs::File::sync_range(xyco::libc::off64_t offset,
+                                xyco::libc::off64_t len,
+                                unsigned int flags) const -> runtime::Future<utils::Result<void>> {
+  return std::visit([&](const auto &file) { return file.sync_range(offset, len, flags); }, file_);
+}
+
+auto xyco::fs::File::advise(io::Advice advice, off64_t offset, off64_t len) const
+    -> runtime::Future<utils::Result<void>> {
+  return std::visit([&](const auto &file) { return file.advise(advice, offset, len); }, file_);
+}
+
+auto xyco::fs::File::readahead(off64_t offset, size_t len) const
+    -> runtime::Future<utils::Result<void>> {
+  return std::visit([&](const auto &file) { return file.readahead(offset, len); }, file_);
+}
+
+auto xyco::fs::File::resize(uintmax_t size) -> runtime::Future<utils::Result<void>> {
+  return std::visit([&](auto &file) { return file.resize(size); }, file_);
+}
+
+auto xyco::fs::File::seek(off64_t offset, int whence) -> runtime::Future<utils::Result<off64_t>> {
+  return std::visit([&](auto &file) { return file.seek(offset, whence); }, file_);
+}
+
+auto xyco::fs::File::into_c_fd() const -> int {
+  return std::visit([](const auto &file) { return file.into_c_fd(); }, file_);
+}
+
+xyco::fs::File::File(epoll::File &&file) : file_(std::move(file)) {}
+
+xyco::fs::File::File(uring::File &&file) : file_(std::move(file)) {}
+
+auto xyco::fs::OpenOptions::open(std::filesystem::path path)
+    -> runtime::Future<utils::Result<File>> {
+  if (io::backend() != io::Backend::Epoll) {
+    return open_with(into<uring::OpenOptions>(), std::move(path));
+  }
+  return open_with(into<epoll::OpenOptions>(), std::move(path));
+}
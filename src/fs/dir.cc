@@ -0,0 +1,131 @@
+module;
+
+#include <coroutine>
+#include <expected>
+#include <filesystem>
+#include <optional>
+#include <string_view>
+#include <utility>
+
+module xyco.fs.common;
+
+import xyco.task;
+import xyco.runtime_ctx;
+import xyco.libc;
+
+auto into_file_type(unsigned char d_type) -> std::filesystem::file_type {
+  switch (d_type) {
+    case xyco::libc::K_DT_REG:
+      return std::filesystem::file_type::regular;
+    case xyco::libc::K_DT_DIR:
+      return std::filesystem::file_type::directory;
+    case xyco::libc::K_DT_LNK:
+      return std::filesystem::file_type::symlink;
+    case xyco::libc::K_DT_BLK:
+      return std::filesystem::file_type::block;
+    case xyco::libc::K_DT_CHR:
+      return std::filesystem::file_type::character;
+    case xyco::libc::K_DT_FIFO:
+      return std::filesystem::file_type::fifo;
+    case xyco::libc::K_DT_SOCK:
+      return std::filesystem::file_type::socket;
+    default:
+      return std::filesystem::file_type::unknown;
+  }
+}
+
+auto xyco::fs::ReadDir::next() -> runtime::Future<utils::Result<std::optional<DirEntry>>> {
+  if (entries_.empty() && !eof_) {
+    auto result = co_await task::BlockingTask([this]() { return fill(); });
+    if (!result) {
+      co_return std::unexpected(result.error());
+    }
+  }
+  if (entries_.empty()) {
+    co_return std::nullopt;
+  }
+  auto entry = std::move(entries_.front());
+  entries_.pop_front();
+  co_return entry;
+}
+
+auto xyco::fs::ReadDir::operator=(ReadDir &&dir) noexcept -> ReadDir & {
+  if (fd_ != -1) {
+    xyco::libc::close(fd_);
+  }
+  fd_ = std::exchange(dir.fd_, -1);
+  path_ = std::move(dir.path_);
+  options_ = dir.options_;
+  buffer_ = std::move(dir.buffer_);
+  entries_ = std::move(dir.entries_);
+  eof_ = dir.eof_;
+
+  return *this;
+}
+
+xyco::fs::ReadDir::~ReadDir() {
+  if (fd_ != -1) {
+    xyco::libc::close(fd_);
+  }
+}
+
+xyco::fs::ReadDir::ReadDir(int file_descriptor,
+                           std::filesystem::path &&path,
+                           ReadDirOptions options)
+    : fd_(file_descriptor),
+      path_(std::move(path)),
+      options_(options),
+      buffer_(options.buffer_size_) {}
+
+auto xyco::fs::ReadDir::fill() -> utils::Result<void> {
+  while (entries_.empty() && !eof_) {
+    auto read_bytes = xyco::libc::getdents64(fd_, buffer_.data(), buffer_.size());
+    if (read_bytes == -1) {
+      return utils::into_sys_result(-1).transform([]([[maybe_unused]] auto n) {});
+    }
+    eof_ = read_bytes == 0;
+
+    for (decltype(read_bytes) offset = 0; offset < read_bytes;) {
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+      const auto *dirent =
+          reinterpret_cast<const xyco::libc::dirent64_t *>(buffer_.data() + offset);
+      offset += dirent->d_reclen;
+      auto name = std::string_view(static_cast<const char *>(dirent->d_name));
+      if (name == "." || name == "..") {
+        continue;
+      }
+
+      DirEntry entry;
+      entry.path_ = path_ / name;
+      entry.file_type_ = into_file_type(dirent->d_type);
+      entry.inode_ = dirent->d_ino;
+      if (options_.metadata_) {
+        xyco::libc::statx_t stx{};
+        if (xyco::libc::statx(fd_,
+                              static_cast<const char *>(dirent->d_name),
+                              xyco::libc::K_AT_SYMLINK_NOFOLLOW |
+                                  xyco::libc::K_AT_STATX_SYNC_AS_STAT,
+                              xyco::libc::K_STATX_ALL,
+                              &stx) == 0) {
+          entry.metadata_ = Metadata(stx);
+        }
+      }
+      entries_.push_back(std::move(entry));
+    }
+  }
+  return {};
+}
+
+auto xyco::fs::read_dir(std::filesystem::path path, ReadDirOptions options)
+    -> runtime::Future<utils::Result<ReadDir>> {
+  auto file_descriptor = co_await task::BlockingTask([&]() {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg)
+    return utils::into_sys_result(xyco::libc::open(
+        path.c_str(),
+        xyco::libc::K_O_RDONLY | xyco::libc::K_O_DIRECTORY | xyco::libc::K_O_CLOEXEC));
+  });
+  if (!file_descriptor) {
+    co_return std::unexpected(file_descriptor.error());
+  }
+  co_return ReadDir(*file_descriptor, std::move(path), options);
+}
@@ -1,101 +1,17 @@
 module;
 
-#include <sys/sysmacros.h>
-
 #include <coroutine>
 #include <expected>
 #include <filesystem>
+#include <limits>
+#include <span>
 #include <utility>
 
-#include "xyco/utils/result.h"
-
 module xyco.fs.uring;
 
 import xyco.task;
 import xyco.libc;
 
-auto get_file_attr(int file_descriptor)
-    -> xyco::runtime::Future<
-        xyco::utils::Result<std::pair<xyco::libc::stat64_t, xyco::fs::StatxExtraFields>>> {
-  xyco::libc::statx_t stx{};
-  xyco::libc::stat64_t stat{};
-
-  ASYNC_TRY((co_await xyco::task::BlockingTask([&]() {
-              return xyco::utils::into_sys_result(xyco::libc::statx(
-                  file_descriptor,
-                  "\0",
-                  xyco::libc::K_AT_EMPTY_PATH | xyco::libc::K_AT_STATX_SYNC_AS_STAT,
-                  xyco::libc::K_STATX_ALL,
-                  &stx));
-            })).transform([]([[maybe_unused]] auto n) {
-    return std::pair<xyco::libc::stat64_t, xyco::fs::StatxExtraFields>({}, {});
-  }));
-
-  stat.st_dev = makedev(stx.stx_dev_major, stx.stx_dev_minor);
-  stat.st_ino = stx.stx_ino;
-  stat.st_nlink = stx.stx_nlink;
-  stat.st_mode = stx.stx_mode;
-  stat.st_uid = stx.stx_uid;
-  stat.st_gid = stx.stx_gid;
-  stat.st_rdev = makedev(stx.stx_rdev_major, stx.stx_rdev_minor);
-  stat.st_size = static_cast<__off_t>(stx.stx_size);
-  stat.st_blksize = stx.stx_blksize;
-  stat.st_blocks = static_cast<__blkcnt64_t>(stx.stx_blocks);
-  stat.st_atim.tv_sec = stx.stx_atime.tv_sec;
-  stat.st_atim.tv_nsec = stx.stx_atime.tv_nsec;
-  stat.st_mtim.tv_sec = stx.stx_mtime.tv_sec;
-  stat.st_mtim.tv_nsec = stx.stx_mtime.tv_nsec;
-  stat.st_ctim.tv_sec = stx.stx_ctime.tv_sec;
-  stat.st_ctim.tv_nsec = stx.stx_ctime.tv_nsec;
-
-  co_return std::pair<xyco::libc::stat64_t, xyco::fs::StatxExtraFields>(
-      stat,
-      {
-          .stx_mask_ = stx.stx_mask,
-          .stx_btime_ = stx.stx_btime,
-      });
-}
-
-auto xyco::fs::uring::File::modified() const -> runtime::Future<utils::Result<timespec>> {
-  co_return (co_await get_file_attr(fd_)).transform([](auto pair) {
-    auto stat = pair.first;
-    return timespec{.tv_sec = stat.st_mtim.tv_sec, .tv_nsec = stat.st_mtim.tv_nsec};
-  });
-}
-
-auto xyco::fs::uring::File::accessed() const -> runtime::Future<utils::Result<timespec>> {
-  co_return (co_await get_file_attr(fd_)).transform([](auto pair) {
-    auto stat = pair.first;
-    return timespec{.tv_sec = stat.st_atim.tv_sec, .tv_nsec = stat.st_atim.tv_nsec};
-  });
-}
-
-auto xyco::fs::uring::File::created() const -> runtime::Future<utils::Result<timespec>> {
-  auto result = co_await get_file_attr(fd_);
-  if (result) {
-    auto ext = result->second;
-    if ((ext.stx_mask_ & xyco::libc::K_STATX_BTIME) != 0) {
-      co_return timespec{.tv_sec = ext.stx_btime_.tv_sec, .tv_nsec = ext.stx_btime_.tv_nsec};
-    }
-    co_return std::unexpected(
-        utils::Error{.errno_ = std::to_underlying(utils::ErrorKind::Uncategorized),
-                     .info_ = "creation time is not available for the filesystem"});
-  }
-  co_return std::unexpected(
-      utils::Error{.errno_ = std::to_underlying(utils::ErrorKind::Unsupported),
-                   .info_ = "creation time is not available on this platform currently"});
-}
-
-auto xyco::fs::uring::File::size() const -> runtime::Future<utils::Result<uintmax_t>> {
-  co_return co_await task::BlockingTask([&]() {
-    std::error_code error_code;
-    auto len = std::filesystem::file_size(path_, error_code);
-    return !error_code ? utils::Result<uintmax_t>(len)
-                       : std::unexpected(utils::Error{.errno_ = error_code.value(),
-                                                      .info_ = error_code.message()});
-  });
-}
-
 auto xyco::fs::uring::File::status()
     -> runtime::Future<utils::Result<std::filesystem::file_status>> {
   co_return co_await task::BlockingTask([&]() {
@@ -115,6 +31,7 @@ auto xyco::fs::uring::File::status()
 auto xyco::fs::uring::File::set_permissions(std::filesystem::perms prms,
                                             std::filesystem::perm_options opts)
     -> runtime::Future<utils::Result<void>> {
+  metadata_.reset();
   co_return co_await task::BlockingTask([&]() {
     std::error_code error_code;
     std::filesystem::permissions(path_, prms, opts, error_code);
@@ -124,15 +41,131 @@ auto xyco::fs::uring::File::set_permissions(std::filesystem::perms prms,
   });
 }
 
+auto xyco::fs::uring::File::read_vectored(std::span<const xyco::libc::iovec> iovecs)
+    -> runtime::Future<utils::Result<uintptr_t>> {
+  // -1 makes the kernel use and advance the current file position.
+  co_return co_await io::uring::TransferFuture(
+      new_event(),
+      io::uring::IoExtra::Readv{.iovecs_ = iovecs.data(),
+                                .nr_vecs_ = static_cast<unsigned int>(iovecs.size()),
+                                .offset_ = static_cast<uint64_t>(-1)},
+      [this](auto event) { register_event(std::move(event)); });
+}
+
+auto xyco::fs::uring::File::write_vectored(std::span<const xyco::libc::iovec> iovecs)
+    -> runtime::Future<utils::Result<uintptr_t>> {
+  auto result = co_await io::uring::TransferFuture(
+      new_event(),
+      io::uring::IoExtra::Writev{.iovecs_ = iovecs.data(),
+                                 .nr_vecs_ = static_cast<unsigned int>(iovecs.size()),
+                                 .offset_ = static_cast<uint64_t>(-1)},
+      [this](auto event) { register_event(std::move(event)); });
+  metadata_.reset();
+  co_return result;
+}
+
 auto xyco::fs::uring::File::flush() const -> runtime::Future<utils::Result<void>> {
-  co_return co_await task::BlockingTask([this]() {
-    return utils::into_sys_result(xyco::libc::fsync(fd_))
-        .transform([]([[maybe_unused]] auto result) {});
-  });
+  return submit(io::uring::IoExtra::Fsync{});
+}
+
+auto xyco::fs::uring::File::allocate(xyco::libc::off64_t offset,
+                                     xyco::libc::off64_t len,
+                                     int mode) -> runtime::Future<utils::Result<void>> {
+  metadata_.reset();
+  return submit(io::uring::IoExtra::Fallocate{.mode_ = mode,
+                                              .offset_ = static_cast<uint64_t>(offset),
+                                              .len_ = static_cast<uint64_t>(len)});
+}
+
+auto xyco::fs::uring::File::sync_data() const -> runtime::Future<utils::Result<void>> {
+  return submit(io::uring::IoExtra::Fsync{.datasync_ = true});
+}
+
+auto xyco::fs::uring::File::sync_range(xyco::libc::off64_t offset,
+                                       xyco::libc::off64_t len,
+                                       unsigned int flags) const
+    -> runtime::Future<utils::Result<void>> {
+  // The ring takes a 32-bit length, so longer ranges are synced up to the end
+  // of the file instead.
+  auto ring_len =
+      len > std::numeric_limits<unsigned int>::max() ? 0 : static_cast<unsigned int>(len);
+  return submit(io::uring::IoExtra::SyncFileRange{
+      .offset_ = static_cast<uint64_t>(offset), .len_ = ring_len, .flags_ = flags});
+}
+
+auto xyco::fs::uring::File::register_event(std::shared_ptr<runtime::Event> event) const -> void {
+  auto &driver = runtime::RuntimeCtx::get_ctx()->driver();
+  if (direct_ && driver.has_registry<io::uring::IoPollRegistry>()) {
+    driver.Register<io::uring::IoPollRegistry>(std::move(event));
+  } else {
+    driver.Register<io::uring::IoRegistry>(std::move(event));
+  }
+}
+
+auto xyco::fs::uring::File::new_event() const -> std::shared_ptr<runtime::Event> {
+  auto event = std::make_shared<runtime::Event>(
+      runtime::Event{.extra_ = std::make_unique<io::uring::IoExtra>()});
+  dynamic_cast<io::uring::IoExtra *>(event->extra_.get())->fd_ = fd_;
+  return event;
+}
+
+auto xyco::fs::uring::File::submit(decltype(io::uring::IoExtra::args_) args) const
+    -> runtime::Future<utils::Result<void>> {
+  using CoOutput = utils::Result<void>;
+
+  class Future : public runtime::Future<CoOutput> {
+   public:
+    auto poll([[maybe_unused]] runtime::Handle<void> self) -> runtime::Poll<CoOutput> override {
+      auto *extra = dynamic_cast<io::uring::IoExtra *>(event_->extra_.get());
+      if (!extra->state_.get_field<io::uring::IoExtra::State::Completed>()) {
+        event_->future_ = this;
+        runtime::RuntimeCtx::get_ctx()->driver().Register<io::uring::IoRegistry>(event_);
+        return runtime::Pending();
+      }
+      extra->state_.set_field<io::uring::IoExtra::State::Completed, false>();
+      if (extra->return_ >= 0) {
+        logging::info("{} on {}", *extra, self_->fd_);
+        return runtime::Ready<CoOutput>{};
+      }
+      return runtime::Ready<CoOutput>{
+          std::unexpected(utils::Error{.errno_ = -extra->return_, .info_ = ""})};
+    }
+
+    Future(decltype(io::uring::IoExtra::args_) args, const File *self)
+        : runtime::Future<CoOutput>(nullptr),
+          self_(self),
+          event_(std::make_shared<runtime::Event>(
+              runtime::Event{.extra_ = std::make_unique<io::uring::IoExtra>()})) {
+      auto *extra = dynamic_cast<io::uring::IoExtra *>(event_->extra_.get());
+      extra->fd_ = self_->fd_;
+      extra->args_ = args;
+    }
+
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-reference-coroutine-parameters)
+    Future(const Future &future) = delete;
+
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-reference-coroutine-parameters)
+    Future(Future &&future) = delete;
+
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-reference-coroutine-parameters)
+    auto operator=(Future &&future) -> Future & = delete;
+
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-reference-coroutine-parameters)
+    auto operator=(const Future &future) -> Future & = delete;
+
+    ~Future() override = default;
+
+   private:
+    const File *self_;
+    std::shared_ptr<runtime::Event> event_;
+  };
+
+  co_return co_await Future(args, this);
 }
 
-xyco::fs::uring::File::File(int file_descriptor, std::filesystem::path &&path)
-    : FileBase(file_descriptor, std::move(path)) {}
+xyco::fs::uring::File::File(int file_descriptor, std::filesystem::path &&path, bool direct)
+    : FileBase(file_descriptor, std::move(path)),
+      direct_(direct) {}
 
 auto xyco::fs::uring::OpenOptions::open(std::filesystem::path path)
     -> runtime::Future<utils::Result<File>> {
@@ -149,9 +182,12 @@ auto xyco::fs::uring::OpenOptions::open(std::filesystem::path path)
     }
 
     // NOLINTNEXTLINE(clang-analyzer-core.UndefinedBinaryOperatorResult)
-    int flags = xyco::libc::K_O_CLOEXEC | *access_mode | *creation_mode;
+    int flags =
+        xyco::libc::K_O_CLOEXEC | *access_mode | *creation_mode | get_custom_flags();
     // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg)
     return utils::into_sys_result(xyco::libc::open(path.c_str(), flags, mode_))
-        .transform([&](auto file_descriptor) { return File(file_descriptor, std::move(path)); });
+        .transform([&](auto file_descriptor) {
+          return File(file_descriptor, std::move(path), direct_);
+        });
   });
 }
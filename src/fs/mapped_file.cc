@@ -0,0 +1,140 @@
+module;
+
+#include <algorithm>
+#include <cerrno>
+#include <coroutine>
+#include <cstddef>
+#include <expected>
+#include <filesystem>
+#include <span>
+#include <utility>
+
+module xyco.fs.common;
+
+import xyco.task;
+import xyco.runtime_ctx;
+import xyco.libc;
+
+auto page_size() -> size_t {
+  static const auto size = static_cast<size_t>(xyco::libc::sysconf(xyco::libc::K_SC_PAGESIZE));
+  return size;
+}
+
+auto xyco::fs::MappedFile::open(std::filesystem::path path, Prefetch prefetch)
+    -> runtime::Future<utils::Result<MappedFile>> {
+  co_return co_await task::BlockingTask([&]() -> utils::Result<MappedFile> {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg)
+    auto file_descriptor =
+        xyco::libc::open(path.c_str(), xyco::libc::K_O_RDONLY | xyco::libc::K_O_CLOEXEC);
+    if (file_descriptor == -1) {
+      return utils::into_sys_result(-1).transform(
+          []([[maybe_unused]] auto n) { return MappedFile(nullptr, 0); });
+    }
+    xyco::libc::stat64_t stat{};
+    if (xyco::libc::fstat64(file_descriptor, &stat) == -1) {
+      auto result = utils::into_sys_result(-1).transform(
+          []([[maybe_unused]] auto n) { return MappedFile(nullptr, 0); });
+      xyco::libc::close(file_descriptor);
+      return result;
+    }
+    // `mmap` rejects empty mappings.
+    if (stat.st_size == 0) {
+      xyco::libc::close(file_descriptor);
+      return MappedFile(nullptr, 0);
+    }
+
+    auto size = static_cast<size_t>(stat.st_size);
+    auto flags = xyco::libc::K_MAP_SHARED;
+    if (prefetch == Prefetch::Populate) {
+      flags |= xyco::libc::K_MAP_POPULATE;
+    }
+    auto *data =
+        xyco::libc::mmap(nullptr, size, xyco::libc::K_PROT_READ, flags, file_descriptor, 0);
+    // The mapping keeps its own reference to the file.
+    auto mmap_errno = errno;
+    xyco::libc::close(file_descriptor);
+    if (data == xyco::libc::K_MAP_FAILED) {
+      errno = mmap_errno;
+      return utils::into_sys_result(-1).transform(
+          []([[maybe_unused]] auto n) { return MappedFile(nullptr, 0); });
+    }
+    if (prefetch == Prefetch::Advise) {
+      // Readahead is only a hint, so its failure does not fail the open.
+      xyco::libc::madvise(data, size, xyco::libc::K_MADV_WILLNEED);
+    }
+    return MappedFile(static_cast<char *>(data), size);
+  });
+}
+
+auto xyco::fs::MappedFile::advise(Advice advice, size_t offset, size_t len) const
+    -> runtime::Future<utils::Result<void>> {
+  auto pages = page_range(offset, len);
+  if (!pages) {
+    co_return pages.transform([]([[maybe_unused]] auto span) {});
+  }
+  if (pages->empty()) {
+    co_return utils::Result<void>();
+  }
+
+  auto flag = xyco::libc::K_MADV_NORMAL;
+  switch (advice) {
+    case Advice::Normal:
+      break;
+    case Advice::Sequential:
+      flag = xyco::libc::K_MADV_SEQUENTIAL;
+      break;
+    case Advice::Random:
+      flag = xyco::libc::K_MADV_RANDOM;
+      break;
+    case Advice::WillNeed:
+      flag = xyco::libc::K_MADV_WILLNEED;
+      break;
+  }
+  // `MADV_WILLNEED` may block to submit readahead.
+  co_return co_await task::BlockingTask([&]() {
+    return utils::into_sys_result(xyco::libc::madvise(pages->data(), pages->size(), flag))
+        .transform([]([[maybe_unused]] auto n) {});
+  });
+}
+
+auto xyco::fs::MappedFile::prefetch(size_t offset, size_t len) const
+    -> runtime::Future<utils::Result<void>> {
+  auto pages = page_range(offset, len);
+  if (!pages) {
+    co_return pages.transform([]([[maybe_unused]] auto span) {});
+  }
+
+  co_return co_await task::BlockingTask([&]() -> utils::Result<void> {
+    // Reading one byte per page is enough to fault it in.
+    for (size_t i = 0; i < pages->size(); i += page_size()) {
+      static_cast<void>(*static_cast<volatile const char *>(pages->data() + i));
+    }
+    return {};
+  });
+}
+
+auto xyco::fs::MappedFile::operator=(MappedFile &&file) noexcept -> MappedFile & {
+  if (data_ != nullptr) {
+    xyco::libc::munmap(data_, size_);
+  }
+  data_ = std::exchange(file.data_, nullptr);
+  size_ = std::exchange(file.size_, 0);
+
+  return *this;
+}
+
+xyco::fs::MappedFile::~MappedFile() {
+  if (data_ != nullptr) {
+    xyco::libc::munmap(data_, size_);
+  }
+}
+
+auto xyco::fs::MappedFile::page_range(size_t offset, size_t len) const
+    -> utils::Result<std::span<char>> {
+  if (offset > size_) {
+    return std::unexpected(utils::Error{.errno_ = EINVAL, .info_ = "offset past end of file"});
+  }
+  auto end = offset + std::min(len, size_ - offset);
+  auto begin = offset / page_size() * page_size();
+  return std::span<char>(data_ + begin, end - begin);
+}
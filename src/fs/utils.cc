@@ -1,13 +1,103 @@
 module;
 
+#include <cerrno>
 #include <coroutine>
+#include <cstddef>
 #include <expected>
 #include <filesystem>
+#include <tuple>
 
 module xyco.fs.common;
 
 import xyco.task;
 import xyco.runtime_ctx;
+import xyco.libc;
+
+// Bytes moved by one `copy_file_range` in the blocking pool.
+constexpr size_t COPY_CHUNK_SIZE = 16 * 1024 * 1024;
+
+// Closes the descriptor once the copy finishes or is cancelled.
+class OwnedFd {
+ public:
+  [[nodiscard]] auto get() const -> int { return fd_; }
+
+  explicit OwnedFd(int file_descriptor) : fd_(file_descriptor) {}
+
+  OwnedFd(const OwnedFd &) = delete;
+
+  OwnedFd(OwnedFd &&) = delete;
+
+  auto operator=(const OwnedFd &) -> OwnedFd & = delete;
+
+  auto operator=(OwnedFd &&) -> OwnedFd & = delete;
+
+  ~OwnedFd() { xyco::libc::close(fd_); }
+
+ private:
+  int fd_;
+};
+
+auto has_option(std::filesystem::copy_options options, std::filesystem::copy_options option)
+    -> bool {
+  return (options & option) != std::filesystem::copy_options::none;
+}
+
+// Returns the error of the last failed call and closes `file_descriptor`.
+auto close_with_error(int file_descriptor) -> xyco::utils::Result<int> {
+  auto result = xyco::utils::into_sys_result(-1);
+  xyco::libc::close(file_descriptor);
+  return result;
+}
+
+// Opens `to_path` for the copy of a file described by `from_stat`. Returns -1 if
+// `options` tell to keep an existing file.
+auto open_copy_target(const std::filesystem::path &to_path,
+                      std::filesystem::copy_options options,
+                      const xyco::libc::stat64_t &from_stat) -> xyco::utils::Result<int> {
+  auto mode = from_stat.st_mode & static_cast<mode_t>(std::filesystem::perms::mask);
+  auto flags = xyco::libc::K_O_WRONLY | xyco::libc::K_O_CREAT | xyco::libc::K_O_CLOEXEC;
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg)
+  auto file_descriptor = xyco::libc::open(to_path.c_str(), flags | xyco::libc::K_O_EXCL, mode);
+  if (file_descriptor == -1 && errno != EEXIST) {
+    return xyco::utils::into_sys_result(-1);
+  }
+
+  if (file_descriptor == -1) {
+    if (has_option(options, std::filesystem::copy_options::skip_existing)) {
+      return -1;
+    }
+    if (!has_option(options, std::filesystem::copy_options::overwrite_existing) &&
+        !has_option(options, std::filesystem::copy_options::update_existing)) {
+      return std::unexpected(xyco::utils::Error{.errno_ = EEXIST, .info_ = ""});
+    }
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg)
+    file_descriptor = xyco::libc::open(to_path.c_str(), flags);
+    if (file_descriptor == -1) {
+      return xyco::utils::into_sys_result(-1);
+    }
+    xyco::libc::stat64_t to_stat{};
+    if (xyco::libc::fstat64(file_descriptor, &to_stat) == -1) {
+      return close_with_error(file_descriptor);
+    }
+    if (to_stat.st_dev == from_stat.st_dev && to_stat.st_ino == from_stat.st_ino) {
+      xyco::libc::close(file_descriptor);
+      return std::unexpected(xyco::utils::Error{.errno_ = EEXIST, .info_ = ""});
+    }
+    if (has_option(options, std::filesystem::copy_options::update_existing) &&
+        std::tie(to_stat.st_mtim.tv_sec, to_stat.st_mtim.tv_nsec) >=
+            std::tie(from_stat.st_mtim.tv_sec, from_stat.st_mtim.tv_nsec)) {
+      xyco::libc::close(file_descriptor);
+      return -1;
+    }
+    if (xyco::libc::ftruncate64(file_descriptor, 0) == -1) {
+      return close_with_error(file_descriptor);
+    }
+  }
+  if (xyco::libc::fchmod(file_descriptor, mode) == -1) {
+    return close_with_error(file_descriptor);
+  }
+  return file_descriptor;
+}
 
 auto xyco::fs::rename(std::filesystem::path old_path,
                       std::filesystem::path new_path) -> runtime::Future<utils::Result<void>> {
@@ -34,14 +124,79 @@ auto xyco::fs::remove(std::filesystem::path path) -> runtime::Future<utils::Resu
 
 auto xyco::fs::copy_file(std::filesystem::path from_path,
                          std::filesystem::path to_path,
-                         std::filesystem::copy_options options)
-    -> runtime::Future<utils::Result<bool>> {
-  co_return co_await task::BlockingTask([&]() {
-    std::error_code error_code;
-    auto ret = std::filesystem::copy_file(from_path, to_path, options, error_code);
+                         std::filesystem::copy_options options,
+                         CopyProgress progress) -> runtime::Future<utils::Result<bool>> {
+  xyco::libc::stat64_t from_stat{};
+  auto from_fd = co_await task::BlockingTask([&]() -> utils::Result<int> {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg)
+    auto file_descriptor = xyco::libc::open(from_path.c_str(),
+                                            xyco::libc::K_O_RDONLY | xyco::libc::K_O_CLOEXEC);
+    if (file_descriptor == -1) {
+      return utils::into_sys_result(-1);
+    }
+    if (xyco::libc::fstat64(file_descriptor, &from_stat) == -1) {
+      return close_with_error(file_descriptor);
+    }
+    return file_descriptor;
+  });
+  if (!from_fd) {
+    co_return std::unexpected(from_fd.error());
+  }
+  OwnedFd from_file(*from_fd);
+  if ((from_stat.st_mode & xyco::libc::K_S_IFMT) != xyco::libc::K_S_IFREG) {
+    co_return std::unexpected(utils::Error{.errno_ = ENOTSUP, .info_ = "not a regular file"});
+  }
 
-    return !error_code ? utils::Result<bool>(ret)
-                       : std::unexpected(utils::Error{.errno_ = error_code.value(),
-                                                      .info_ = error_code.message()});
+  auto to_fd = co_await task::BlockingTask(
+      [&]() { return open_copy_target(to_path, options, from_stat); });
+  if (!to_fd) {
+    co_return std::unexpected(to_fd.error());
+  }
+  if (*to_fd == -1) {
+    co_return false;
+  }
+  OwnedFd to_file(*to_fd);
+
+  auto total = static_cast<uintmax_t>(from_stat.st_size);
+  auto cloned = co_await task::BlockingTask([&]() {
+    return xyco::libc::ioctl(to_file.get(), xyco::libc::K_FICLONE, from_file.get()) == 0;
   });
+  if (cloned) {
+    if (progress) {
+      progress(total, total);
+    }
+    co_return true;
+  }
+
+  uintmax_t copied = 0;
+  auto use_sendfile = false;
+  while (true) {
+    auto copy_result = co_await task::BlockingTask([&]() {
+      auto nbytes =
+          use_sendfile
+              ? xyco::libc::sendfile(to_file.get(), from_file.get(), nullptr, COPY_CHUNK_SIZE)
+              : xyco::libc::copy_file_range(
+                    from_file.get(), nullptr, to_file.get(), nullptr, COPY_CHUNK_SIZE, 0);
+      return utils::into_sys_result(static_cast<int>(nbytes));
+    });
+    if (!copy_result) {
+      // `copy_file_range` fails across filesystems before Linux 5.3 and on some
+      // filesystems, which `sendfile` continues from the same file positions.
+      auto error = copy_result.error().errno_;
+      if (!use_sendfile &&
+          (error == EXDEV || error == EINVAL || error == ENOSYS || error == EOPNOTSUPP)) {
+        use_sendfile = true;
+        continue;
+      }
+      co_return std::unexpected(copy_result.error());
+    }
+    if (*copy_result == 0) {
+      break;
+    }
+    copied += static_cast<uintmax_t>(*copy_result);
+    if (progress) {
+      progress(copied, total);
+    }
+  }
+  co_return true;
 }
@@ -0,0 +1,70 @@
+module;
+
+#include <liburing.h>
+
+#include <algorithm>
+#include <array>
+#include <mutex>
+
+module xyco.io;
+
+import xyco.logging;
+
+// Opcodes submitted by `fs::uring::File`, available since Linux 5.6.
+constexpr std::array FILE_OPS = {IORING_OP_READ,
+                                 IORING_OP_WRITE,
+                                 IORING_OP_READV,
+                                 IORING_OP_WRITEV,
+                                 IORING_OP_FSYNC,
+                                 IORING_OP_FALLOCATE,
+                                 IORING_OP_SYNC_FILE_RANGE,
+                                 IORING_OP_ASYNC_CANCEL};
+
+// Opcodes only submitted by `net::uring` sockets. `IORING_OP_MSG_RING`, which
+// wakes other workers, is left out: without it `uring::IoRegistryImpl::wake_up`
+// does nothing and peers wake at their select timeout instead.
+constexpr std::array SOCKET_OPS = {IORING_OP_SPLICE,
+                                   IORING_OP_CLOSE,
+                                   IORING_OP_ACCEPT,
+                                   IORING_OP_CONNECT,
+                                   IORING_OP_SHUTDOWN};
+
+std::once_flag backend_flag;
+xyco::io::Backend selected_backend = xyco::io::Backend::Epoll;
+
+auto probe_backend() -> xyco::io::Backend {
+  // Fails without io_uring support or if it is disabled, e.g. by
+  // `kernel.io_uring_disabled` or a seccomp filter.
+  auto *probe = io_uring_get_probe();
+  if (probe == nullptr) {
+    logging::info("io_uring unavailable, use epoll");
+    return xyco::io::Backend::Epoll;
+  }
+  auto supported = [&](const auto &opcodes) {
+    return std::ranges::all_of(
+        opcodes, [&](auto opcode) { return io_uring_opcode_supported(probe, opcode) != 0; });
+  };
+  auto backend = xyco::io::Backend::Epoll;
+  if (supported(FILE_OPS)) {
+    backend = supported(SOCKET_OPS) ? xyco::io::Backend::IoUring : xyco::io::Backend::Hybrid;
+  }
+  io_uring_free_probe(probe);
+  if (backend == xyco::io::Backend::Epoll) {
+    logging::info("io_uring lacks file operations, use epoll");
+  }
+  return backend;
+}
+
+auto xyco::io::backend() -> Backend {
+  std::call_once(backend_flag, []() { selected_backend = probe_backend(); });
+  return selected_backend;
+}
+
+auto xyco::io::use_backend(Backend backend) -> bool {
+  auto used = false;
+  std::call_once(backend_flag, [&]() {
+    selected_backend = backend;
+    used = true;
+  });
+  return used;
+}
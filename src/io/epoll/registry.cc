@@ -1,8 +1,10 @@
 module;
 
 #include <sys/epoll.h>
+#include <sys/eventfd.h>
 
-#include <array>
+#include <algorithm>
+#include <chrono>
 #include <expected>
 #include <format>
 #include <mutex>
@@ -31,6 +33,9 @@ auto to_sys(xyco::io::epoll::IoExtra::Interest interest) -> int {
   }
 }
 
+// Edge mode watches both directions for the whole lifetime of the fd.
+constexpr uint32_t EDGE_EVENTS = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+
 auto to_state(uint32_t events) -> xyco::io::epoll::IoExtra::State {
   xyco::io::epoll::IoExtra::State state{};
   state.set_field<xyco::io::epoll::IoExtra::State::Registered>();
@@ -51,6 +56,50 @@ auto to_state(uint32_t events) -> xyco::io::epoll::IoExtra::State {
   return state;
 }
 
+// Edge mode caches readiness until a wait consumes it, so a hang up only makes
+// the fd readable or writable and the next syscall reports EOF or `EPIPE`. Only
+// `EPOLLERR` sets the sticky `Error`.
+auto to_edge_state(uint32_t events) -> xyco::io::epoll::IoExtra::State {
+  xyco::io::epoll::IoExtra::State state{};
+  state.set_field<xyco::io::epoll::IoExtra::State::Registered>();
+  if ((events & EPOLLERR) != 0U) {
+    state.set_field<xyco::io::epoll::IoExtra::State::Error>();
+    return state;
+  }
+  if ((events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP)) != 0U) {
+    state.set_field<xyco::io::epoll::IoExtra::State::Readable>();
+  }
+  if ((events & (EPOLLOUT | EPOLLHUP)) != 0U) {
+    state.set_field<xyco::io::epoll::IoExtra::State::Writable>();
+  }
+  return state;
+}
+
+// Returns whether the cached readiness of `extra` satisfies its interest and
+// clears the readiness it consumes. Errors stay set until deregistration.
+auto consume_readiness(xyco::io::epoll::IoExtra &extra) -> bool {
+  using State = xyco::io::epoll::IoExtra::State;
+
+  auto &state = extra.state_;
+  if (state.get_field<State::Error>()) {
+    return true;
+  }
+  auto readable = state.get_field<State::Readable>();
+  auto writable = state.get_field<State::Writable>();
+  switch (extra.interest_) {
+    case xyco::io::epoll::IoExtra::Interest::Read:
+      state.set_field<State::Readable, false>();
+      return readable;
+    case xyco::io::epoll::IoExtra::Interest::Write:
+      state.set_field<State::Writable, false>();
+      return writable;
+    case xyco::io::epoll::IoExtra::Interest::All:
+      state.set_field<State::Readable, false>();
+      state.set_field<State::Writable, false>();
+      return readable || writable;
+  }
+}
+
 template <>
 struct std::formatter<epoll_event> : public std::formatter<bool> {
   template <typename FormatContext>
@@ -65,6 +114,26 @@ struct std::formatter<epoll_event> : public std::formatter<bool> {
 auto xyco::io::epoll::IoRegistryImpl::Register(std::shared_ptr<runtime::Event> event)
     -> utils::Result<void> {
   auto *extra = dynamic_cast<io::epoll::IoExtra *>(event->extra_.get());
+  if (mode_ == Mode::Edge) {
+    epoll_event epoll_event{.events = EDGE_EVENTS, .data = {.ptr = event.get()}};
+
+    {
+      std::scoped_lock<std::mutex> lock_guard(events_mutex_);
+      edge_events_.emplace(event.get(), event);
+      extra->state_.set_field<io::epoll::IoExtra::State::Registered>();
+    }
+    auto result =
+        utils::into_sys_result(::epoll_ctl(epfd_, EPOLL_CTL_ADD, extra->fd_, &epoll_event));
+    if (!result) {
+      std::scoped_lock<std::mutex> lock_guard(events_mutex_);
+      edge_events_.erase(event.get());
+      extra->state_.set_field<io::epoll::IoExtra::State::Registered, false>();
+      return std::unexpected(result.error());
+    }
+    logging::trace("epoll_ctl add:{}", epoll_event);
+    wait_edge(event);
+    return {};
+  }
   epoll_event epoll_event{.events = static_cast<uint32_t>(to_sys((extra->interest_))),
                           .data = {.ptr = event.get()}};
 
@@ -87,6 +156,10 @@ auto xyco::io::epoll::IoRegistryImpl::Register(std::shared_ptr<runtime::Event> e
 
 auto xyco::io::epoll::IoRegistryImpl::reregister(std::shared_ptr<runtime::Event> event)
     -> utils::Result<void> {
+  if (mode_ == Mode::Edge) {
+    wait_edge(event);
+    return {};
+  }
   auto *extra = dynamic_cast<io::epoll::IoExtra *>(event->extra_.get());
   epoll_event epoll_event{static_cast<uint32_t>(to_sys(extra->interest_)), {.ptr = event.get()}};
 
@@ -109,7 +182,9 @@ auto xyco::io::epoll::IoRegistryImpl::reregister(std::shared_ptr<runtime::Event>
 auto xyco::io::epoll::IoRegistryImpl::deregister(std::shared_ptr<runtime::Event> event)
     -> utils::Result<void> {
   auto *extra = dynamic_cast<io::epoll::IoExtra *>(event->extra_.get());
-  epoll_event epoll_event{static_cast<uint32_t>(to_sys(extra->interest_)), {.ptr = event.get()}};
+  epoll_event epoll_event{
+      mode_ == Mode::Edge ? EDGE_EVENTS : static_cast<uint32_t>(to_sys(extra->interest_)),
+      {.ptr = event.get()}};
 
   auto result = utils::into_sys_result(::epoll_ctl(epfd_, EPOLL_CTL_DEL, extra->fd_, &epoll_event));
   if (result) {
@@ -122,6 +197,10 @@ auto xyco::io::epoll::IoRegistryImpl::deregister(std::shared_ptr<runtime::Event>
     if (event_it != registered_events_.end()) {
       registered_events_.erase(event_it);
     }
+    if (mode_ == Mode::Edge) {
+      edge_events_.erase(event.get());
+      std::erase(ready_events_, event);
+    }
     extra->state_.set_field<io::epoll::IoExtra::State::Registered, false>();
   }
 
@@ -131,15 +210,16 @@ auto xyco::io::epoll::IoRegistryImpl::deregister(std::shared_ptr<runtime::Event>
 auto xyco::io::epoll::IoRegistryImpl::select(runtime::Events &events,
                                              std::chrono::milliseconds timeout)
     -> utils::Result<void> {
-  static auto epoll_events = std::array<epoll_event, MAX_EVENTS>();
-
   std::scoped_lock<std::mutex> select_lock_guard(select_mutex_);
 
-  auto select_result = utils::into_sys_result(
-      ::epoll_wait(epfd_,
-                   epoll_events.data(),
-                   MAX_EVENTS,
-                   static_cast<int>(std::min(timeout, MAX_TIMEOUT).count())));
+  timeout = std::min(timeout, MAX_TIMEOUT);
+  if (mode_ == Mode::Edge) {
+    std::scoped_lock<std::mutex> lock_guard(events_mutex_);
+    if (!ready_events_.empty()) {
+      timeout = std::chrono::milliseconds(0);
+    }
+  }
+  auto select_result = wait(timeout);
   if (!select_result) {
     auto err = select_result.error();
     if (err.errno_ != EINTR) {
@@ -148,15 +228,49 @@ auto xyco::io::epoll::IoRegistryImpl::select(runtime::Events &events,
     return {};
   }
   auto ready_len = *select_result;
+  if (mode_ == Mode::Edge) {
+    std::scoped_lock<std::mutex> lock_guard(events_mutex_);
+    for (auto i = 0; i < ready_len; i++) {
+      if (epoll_events_.at(i).data.ptr == &wake_fd_) {
+        eventfd_t count = 0;
+        ::eventfd_read(wake_fd_, &count);
+        continue;
+      }
+      auto event_it =
+          edge_events_.find(static_cast<runtime::Event *>(epoll_events_.at(i).data.ptr));
+      // Watched fds have no event, and others may have been deregistered since
+      // `epoll_wait` returned.
+      if (event_it == edge_events_.end()) {
+        continue;
+      }
+      auto *extra = dynamic_cast<io::epoll::IoExtra *>(event_it->second->extra_.get());
+      extra->state_.merge(to_edge_state(epoll_events_.at(i).events));
+      extra->state_.set_field<io::epoll::IoExtra::State::Pending, false>();
+      logging::trace("select {}", *event_it->second);
+      auto waiting_event =
+          std::find(registered_events_.begin(), registered_events_.end(), event_it->second);
+      if (waiting_event != registered_events_.end() && consume_readiness(*extra)) {
+        events.push_back(*waiting_event);
+        registered_events_.erase(waiting_event);
+      }
+    }
+    events.insert(events.end(), ready_events_.begin(), ready_events_.end());
+    ready_events_.clear();
+    return {};
+  }
   for (auto i = 0; i < ready_len; i++) {
+    // A watched fd, left to the registry owning it.
+    if (epoll_events_.at(i).data.ptr == nullptr) {
+      continue;
+    }
     std::scoped_lock<std::mutex> lock_guard(events_mutex_);
     auto ready_event = std::find_if(registered_events_.begin(),
                                     registered_events_.end(),
                                     [&](auto &registered_event) {
-                                      return epoll_events.at(i).data.ptr == registered_event.get();
+                                      return epoll_events_.at(i).data.ptr == registered_event.get();
                                     });
     dynamic_cast<io::epoll::IoExtra *>(ready_event->get()->extra_.get())->state_ =
-        to_state(epoll_events.at(i).events);
+        to_state(epoll_events_.at(i).events);
     logging::trace("select {}", **ready_event);
     events.push_back(*ready_event);
     registered_events_.erase(ready_event);
@@ -164,10 +278,87 @@ auto xyco::io::epoll::IoRegistryImpl::select(runtime::Events &events,
   return {};
 }
 
-xyco::io::epoll::IoRegistryImpl::IoRegistryImpl(int entries) : epfd_(::epoll_create(entries)) {
+auto xyco::io::epoll::IoRegistryImpl::watch(int file_descriptor) -> utils::Result<void> {
+  epoll_event epoll_event{.events = EPOLLIN, .data = {.ptr = nullptr}};
+
+  auto result =
+      utils::into_sys_result(::epoll_ctl(epfd_, EPOLL_CTL_ADD, file_descriptor, &epoll_event));
+  if (!result && result.error().errno_ == EEXIST) {
+    return {};
+  }
+  if (result) {
+    logging::trace("epoll_ctl watch:{}", file_descriptor);
+  }
+  return result.transform([]([[maybe_unused]] auto result) {});
+}
+
+auto xyco::io::epoll::IoRegistryImpl::wait_edge(const std::shared_ptr<runtime::Event> &event)
+    -> void {
+  std::scoped_lock<std::mutex> lock_guard(events_mutex_);
+  if (consume_readiness(*dynamic_cast<io::epoll::IoExtra *>(event->extra_.get()))) {
+    logging::trace("ready from cache {}", *event);
+    ready_events_.push_back(event);
+    // Ends a `select` blocking in `epoll_wait`, e.g. on another worker sharing
+    // this registry, instead of leaving the event to its timeout.
+    if (ready_events_.size() == 1) {
+      ::eventfd_write(wake_fd_, 1);
+    }
+  } else {
+    registered_events_.push_back(event);
+  }
+}
+
+auto xyco::io::epoll::IoRegistryImpl::wait(std::chrono::milliseconds timeout)
+    -> utils::Result<int> {
+  if (timeout.count() > 0 && busy_poll_.count() > 0) {
+    auto busy_poll_start = std::chrono::steady_clock::now();
+    auto busy_poll_end =
+        busy_poll_start + std::min<std::chrono::microseconds>(busy_poll_, timeout);
+    auto now = busy_poll_start;
+    while (now < busy_poll_end) {
+      auto ready_len = ::epoll_wait(epfd_, epoll_events_.data(), MAX_EVENTS, 0);
+      if (ready_len != 0) {
+        return utils::into_sys_result(ready_len);
+      }
+      now = std::chrono::steady_clock::now();
+    }
+    // Blocks for what the spin left of `timeout`, rounded up to the millisecond
+    // `epoll_wait` takes so that an idle worker sleeps instead of spinning again.
+    timeout = std::max(
+        std::chrono::ceil<std::chrono::milliseconds>(timeout - (now - busy_poll_start)),
+        std::chrono::milliseconds(0));
+  }
+  return utils::into_sys_result(::epoll_wait(epfd_,
+                                             epoll_events_.data(),
+                                             MAX_EVENTS,
+                                             static_cast<int>(timeout.count())));
+}
+
+xyco::io::epoll::IoRegistryImpl::IoRegistryImpl(int entries,
+                                                Mode mode,
+                                                std::chrono::microseconds busy_poll)
+    : epfd_(::epoll_create(entries)),
+      mode_(mode),
+      busy_poll_(busy_poll),
+      epoll_events_(MAX_EVENTS) {
   if (epfd_ == -1) {
     utils::panic();
   }
+  if (mode_ == Mode::Edge) {
+    wake_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    epoll_event epoll_event{.events = EPOLLIN, .data = {.ptr = &wake_fd_}};
+    if (wake_fd_ == -1 || ::epoll_ctl(epfd_, EPOLL_CTL_ADD, wake_fd_, &epoll_event) == -1) {
+      utils::panic();
+    }
+  }
 }
 
-xyco::io::epoll::IoRegistryImpl::~IoRegistryImpl() { xyco::libc::close(epfd_); }
+xyco::io::epoll::IoRegistryImpl::IoRegistryImpl(int entries, Mode mode)
+    : IoRegistryImpl(entries, mode, std::chrono::microseconds(0)) {}
+
+xyco::io::epoll::IoRegistryImpl::~IoRegistryImpl() {
+  if (wake_fd_ != -1) {
+    xyco::libc::close(wake_fd_);
+  }
+  xyco::libc::close(epfd_);
+}
@@ -2,6 +2,7 @@ module;
 
 #include <liburing.h>
 
+#include <cerrno>
 #include <expected>
 #include <format>
 #include <string>
@@ -12,6 +13,23 @@ module xyco.io.uring;
 import xyco.logging;
 import xyco.panic;
 
+namespace {
+// `IORING_OP_MSG_RING` requires Linux 5.18, newer than any other opcode the
+// ring submits, so it is probed on its own.
+auto msg_ring_supported() -> bool {
+  static const bool supported = []() {
+    auto* probe = io_uring_get_probe();
+    if (probe == nullptr) {
+      return false;
+    }
+    auto supported = io_uring_opcode_supported(probe, IORING_OP_MSG_RING) != 0;
+    io_uring_free_probe(probe);
+    return supported;
+  }();
+  return supported;
+}
+}  // namespace
+
 auto xyco::io::uring::IoExtra::print() const -> std::string { return std::format("{}", *this); }
 
 auto xyco::io::uring::IoRegistryImpl::Register(std::shared_ptr<runtime::Event> event)
@@ -42,12 +60,77 @@ auto xyco::io::uring::IoRegistryImpl::Register(std::shared_ptr<runtime::Event> e
 
       io_uring_prep_write(sqe, extra->fd_, write_args.buf_, write_args.len_, write_args.offset_);
     }
+    // readv
+    if (std::holds_alternative<uring::IoExtra::Readv>(extra->args_)) {
+      auto readv_args = std::get<uring::IoExtra::Readv>(extra->args_);
+      logging::trace("readv:fd={} user_data={}", extra->fd_, static_cast<void*>(event.get()));
+
+      io_uring_prep_readv(sqe,
+                          extra->fd_,
+                          readv_args.iovecs_,
+                          readv_args.nr_vecs_,
+                          readv_args.offset_);
+    }
+    // writev
+    if (std::holds_alternative<uring::IoExtra::Writev>(extra->args_)) {
+      auto writev_args = std::get<uring::IoExtra::Writev>(extra->args_);
+      logging::trace("writev:fd={} user_data={}", extra->fd_, static_cast<void*>(event.get()));
+
+      io_uring_prep_writev(sqe,
+                           extra->fd_,
+                           writev_args.iovecs_,
+                           writev_args.nr_vecs_,
+                           writev_args.offset_);
+    }
+    // splice
+    if (std::holds_alternative<uring::IoExtra::Splice>(extra->args_)) {
+      auto splice_args = std::get<uring::IoExtra::Splice>(extra->args_);
+      logging::trace("splice:fd={} user_data={}", extra->fd_, static_cast<void*>(event.get()));
+
+      io_uring_prep_splice(sqe,
+                           splice_args.fd_in_,
+                           splice_args.off_in_,
+                           extra->fd_,
+                           splice_args.off_out_,
+                           splice_args.len_,
+                           splice_args.flags_);
+    }
     // close
     if (std::holds_alternative<uring::IoExtra::Close>(extra->args_)) {
       logging::trace("close:fd={} user_data={}", extra->fd_, static_cast<void*>(event.get()));
 
       io_uring_prep_close(sqe, extra->fd_);
     }
+    // fsync
+    if (std::holds_alternative<uring::IoExtra::Fsync>(extra->args_)) {
+      auto fsync_args = std::get<uring::IoExtra::Fsync>(extra->args_);
+      logging::trace("fsync:fd={} user_data={}", extra->fd_, static_cast<void*>(event.get()));
+
+      io_uring_prep_fsync(sqe, extra->fd_, fsync_args.datasync_ ? IORING_FSYNC_DATASYNC : 0);
+    }
+    // fallocate
+    if (std::holds_alternative<uring::IoExtra::Fallocate>(extra->args_)) {
+      auto fallocate_args = std::get<uring::IoExtra::Fallocate>(extra->args_);
+      logging::trace("fallocate:fd={} user_data={}", extra->fd_, static_cast<void*>(event.get()));
+
+      io_uring_prep_fallocate(sqe,
+                              extra->fd_,
+                              fallocate_args.mode_,
+                              fallocate_args.offset_,
+                              fallocate_args.len_);
+    }
+    // sync_file_range
+    if (std::holds_alternative<uring::IoExtra::SyncFileRange>(extra->args_)) {
+      auto sync_args = std::get<uring::IoExtra::SyncFileRange>(extra->args_);
+      logging::trace(
+          "sync_file_range:fd={} user_data={}", extra->fd_, static_cast<void*>(event.get()));
+
+      io_uring_prep_sync_file_range(sqe,
+                                    extra->fd_,
+                                    sync_args.len_,
+                                    sync_args.offset_,
+                                    static_cast<int>(sync_args.flags_));
+    }
     // accept
     if (std::holds_alternative<uring::IoExtra::Accept>(extra->args_)) {
       auto accept_args = std::get<uring::IoExtra::Accept>(extra->args_);
@@ -113,11 +196,54 @@ auto xyco::io::uring::IoRegistryImpl::deregister(std::shared_ptr<runtime::Event>
   return std::unexpected(utils::Error{.errno_ = 1, .info_ = ""});
 }
 
-xyco::io::uring::IoRegistryImpl::IoRegistryImpl(uint32_t entries) : io_uring_() {
-  auto result = io_uring_queue_init(entries, &io_uring_, 0);
+auto xyco::io::uring::IoRegistryImpl::wake_up(runtime::Registry& peer) -> utils::Result<void> {
+  auto* peer_registry = dynamic_cast<IoRegistryImpl*>(&peer);
+  if (peer_registry == nullptr || !msg_ring_supported()) {
+    return {};
+  }
+
+  auto* sqe = io_uring_get_sqe(&io_uring_);
+  if (sqe == nullptr) {  // sq full
+    io_uring_submit(&io_uring_);
+    sqe = io_uring_get_sqe(&io_uring_);
+  }
+
+  if (sqe != nullptr) {
+    // Both the message posted to `peer` and the completion on the current ring
+    // carry no `user_data` so that `select` skips them.
+    io_uring_prep_msg_ring(sqe, peer_registry->io_uring_.ring_fd, 0, 0, 0);
+    io_uring_sqe_set_data(sqe, nullptr);
+    logging::trace("msg_ring:fd={}", peer_registry->io_uring_.ring_fd);
+
+    io_uring_submit(&io_uring_);
+
+    return {};
+  }
+
+  return std::unexpected(utils::Error{.errno_ = EBUSY, .info_ = "submission queue full"});
+}
+
+xyco::io::uring::IoRegistryImpl::IoRegistryImpl(uint32_t entries,
+                                                std::chrono::microseconds busy_poll)
+    : IoRegistryImpl(entries, 0, busy_poll) {}
+
+xyco::io::uring::IoRegistryImpl::IoRegistryImpl(uint32_t entries, Wait wait)
+    : IoRegistryImpl(entries, 0) {
+  wait_ = wait;
+}
+
+xyco::io::uring::IoRegistryImpl::IoRegistryImpl(uint32_t entries,
+                                                uint32_t flags,
+                                                std::chrono::microseconds busy_poll)
+    : io_uring_(),
+      busy_poll_(busy_poll) {
+  auto result = io_uring_queue_init(entries, &io_uring_, flags);
   if (result != 0) {
     utils::panic();
   }
 }
 
 xyco::io::uring::IoRegistryImpl::~IoRegistryImpl() { io_uring_queue_exit(&io_uring_); }
+
+xyco::io::uring::IoPollRegistryImpl::IoPollRegistryImpl(uint32_t entries)
+    : IoRegistryImpl(entries, IORING_SETUP_IOPOLL) {}
@@ -0,0 +1,167 @@
+module;
+
+#include <chrono>
+#include <expected>
+#include <span>
+#include <utility>
+#include <variant>
+#include <vector>
+
+module xyco.net;
+
+// Converts the result of a backend future into the matching wrapper type.
+template <typename T, typename U>
+auto wrap(xyco::runtime::Future<xyco::utils::Result<U>> future)
+    -> xyco::runtime::Future<xyco::utils::Result<T>> {
+  co_return (co_await future).transform([](U inner) { return T(std::move(inner)); });
+}
+
+template <typename Stream>
+auto wrap_accepted(std::pair<Stream, xyco::net::SocketAddr> accepted)
+    -> std::pair<xyco::net::TcpStream, xyco::net::SocketAddr> {
+  return {xyco::net::TcpStream(std::move(accepted.first)), accepted.second};
+}
+
+template <typename Listener>
+auto accept_from(Listener *listener)
+    -> xyco::runtime::Future<
+        xyco::utils::Result<std::pair<xyco::net::TcpStream, xyco::net::SocketAddr>>> {
+  co_return (co_await listener->accept()).transform([](auto accepted) {
+    return wrap_accepted(std::move(accepted));
+  });
+}
+
+template <typename Listener>
+auto accept_batch_from(Listener *listener, size_t max_batch)
+    -> xyco::runtime::Future<
+        xyco::utils::Result<std::vector<std::pair<xyco::net::TcpStream, xyco::net::SocketAddr>>>> {
+  co_return (co_await listener->accept_batch(max_batch)).transform([](auto batch) {
+    std::vector<std::pair<xyco::net::TcpStream, xyco::net::SocketAddr>> accepted;
+    accepted.reserve(batch.size());
+    for (auto &stream : batch) {
+      accepted.push_back(wrap_accepted(std::move(stream)));
+    }
+    return accepted;
+  });
+}
+
+auto use_io_uring() -> bool { return xyco::io::backend() == xyco::io::Backend::IoUring; }
+
+auto xyco::net::TcpSocket::bind(SocketAddr addr) -> Future<utils::Result<void>> {
+  return std::visit([&](auto &socket) { return socket.bind(addr); }, socket_);
+}
+
+auto xyco::net::TcpSocket::connect(SocketAddr addr) -> Future<utils::Result<TcpStream>> {
+  return std::visit([&](auto &socket) { return wrap<TcpStream>(socket.connect(addr)); },
+                    socket_);
+}
+
+auto xyco::net::TcpSocket::listen(int backlog) -> Future<utils::Result<TcpListener>> {
+  return std::visit([&](auto &socket) { return wrap<TcpListener>(socket.listen(backlog)); },
+                    socket_);
+}
+
+auto xyco::net::TcpSocket::set_reuseaddr(bool reuseaddr) -> utils::Result<void> {
+  return std::visit([&](auto &socket) { return socket.set_reuseaddr(reuseaddr); }, socket_);
+}
+
+auto xyco::net::TcpSocket::set_reuseport(bool reuseport) -> utils::Result<void> {
+  return std::visit([&](auto &socket) { return socket.set_reuseport(reuseport); }, socket_);
+}
+
+auto xyco::net::TcpSocket::new_v4() -> utils::Result<TcpSocket> {
+  if (use_io_uring()) {
+    return uring::TcpSocket::new_v4().transform([](auto socket) {
+      return TcpSocket(std::move(socket));
+    });
+  }
+  return epoll::TcpSocket::new_v4().transform([](auto socket) {
+    return TcpSocket(std::move(socket));
+  });
+}
+
+auto xyco::net::TcpSocket::new_v6() -> utils::Result<TcpSocket> {
+  if (use_io_uring()) {
+    return uring::TcpSocket::new_v6().transform([](auto socket) {
+      return TcpSocket(std::move(socket));
+    });
+  }
+  return epoll::TcpSocket::new_v6().transform([](auto socket) {
+    return TcpSocket(std::move(socket));
+  });
+}
+
+xyco::net::TcpSocket::TcpSocket(epoll::TcpSocket &&socket) : socket_(std::move(socket)) {}
+
+xyco::net::TcpSocket::TcpSocket(uring::TcpSocket &&socket) : socket_(std::move(socket)) {}
+
+auto xyco::net::TcpStream::connect(SocketAddr addr) -> Future<utils::Result<TcpStream>> {
+  if (use_io_uring()) {
+    return wrap<TcpStream>(uring::TcpStream::connect(addr));
+  }
+  return wrap<TcpStream>(epoll::TcpStream::connect(addr));
+}
+
+auto xyco::net::TcpStream::read_vectored(std::span<const xyco::libc::iovec> iovecs)
+    -> Future<utils::Result<uintptr_t>> {
+  return std::visit([&](auto &stream) { return stream.read_vectored(iovecs); }, stream_);
+}
+
+auto xyco::net::TcpStream::write_vectored(std::span<const xyco::libc::iovec> iovecs)
+    -> Future<utils::Result<uintptr_t>> {
+  return std::visit([&](auto &stream) { return stream.write_vectored(iovecs); }, stream_);
+}
+
+auto xyco::net::TcpStream::send_file(int file_descriptor, xyco::libc::off64_t offset, size_t len)
+    -> Future<utils::Result<uintptr_t>> {
+  return std::visit(
+      [&](auto &stream) { return stream.send_file(file_descriptor, offset, len); }, stream_);
+}
+
+auto xyco::net::TcpStream::flush() -> Future<utils::Result<void>> {
+  return std::visit([](auto &stream) { return stream.flush(); }, stream_);
+}
+
+auto xyco::net::TcpStream::set_busy_poll(std::chrono::microseconds budget)
+    -> utils::Result<void> {
+  return std::visit([&](auto &stream) { return stream.set_busy_poll(budget); }, stream_);
+}
+
+auto xyco::net::TcpStream::shutdown(io::Shutdown shutdown) -> Future<utils::Result<void>> {
+  return std::visit([&](auto &stream) { return stream.shutdown(shutdown); }, stream_);
+}
+
+xyco::net::TcpStream::TcpStream(epoll::TcpStream &&stream) : stream_(std::move(stream)) {}
+
+xyco::net::TcpStream::TcpStream(uring::TcpStream &&stream) : stream_(std::move(stream)) {}
+
+auto xyco::net::TcpListener::bind(SocketAddr addr) -> Future<utils::Result<TcpListener>> {
+  if (use_io_uring()) {
+    return wrap<TcpListener>(uring::TcpListener::bind(addr));
+  }
+  return wrap<TcpListener>(epoll::TcpListener::bind(addr));
+}
+
+auto xyco::net::TcpListener::bind_per_worker(SocketAddr addr)
+    -> Future<utils::Result<TcpListener>> {
+  if (use_io_uring()) {
+    return wrap<TcpListener>(uring::TcpListener::bind_per_worker(addr));
+  }
+  return wrap<TcpListener>(epoll::TcpListener::bind_per_worker(addr));
+}
+
+auto xyco::net::TcpListener::accept() -> Future<utils::Result<std::pair<TcpStream, SocketAddr>>> {
+  return std::visit([](auto &listener) { return accept_from(&listener); }, listener_);
+}
+
+auto xyco::net::TcpListener::accept_batch(size_t max_batch)
+    -> Future<utils::Result<std::vector<std::pair<TcpStream, SocketAddr>>>> {
+  return std::visit([&](auto &listener) { return accept_batch_from(&listener, max_batch); },
+                    listener_);
+}
+
+xyco::net::TcpListener::TcpListener(epoll::TcpListener &&listener)
+    : listener_(std::move(listener)) {}
+
+xyco::net::TcpListener::TcpListener(uring::TcpListener &&listener)
+    : listener_(std::move(listener)) {}
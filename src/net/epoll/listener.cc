@@ -5,6 +5,8 @@ module;
 #include <coroutine>
 #include <expected>
 #include <gsl/pointers>
+#include <span>
+#include <utility>
 
 #include "xyco/utils/result.h"
 
@@ -13,13 +15,29 @@ module xyco.net.epoll;
 import xyco.logging;
 import xyco.error;
 import xyco.task;
-import xyco.io;
+import xyco.io.common;
+import xyco.io.epoll;
 import xyco.net.common;
 import xyco.libc;
 
 template <typename T>
 using Future = xyco::runtime::Future<T>;
 
+// The epoll registry of the current worker: the shared `IoRegistry` if added,
+// otherwise the worker's own `LocalIoRegistry`. Fails with `ENXIO` if there is
+// neither.
+auto io_registry() -> xyco::utils::Result<std::shared_ptr<xyco::runtime::Registry>> {
+  auto &driver = xyco::runtime::RuntimeCtx::get_ctx()->driver();
+  if (driver.has_registry<xyco::io::epoll::IoRegistry>()) {
+    return driver.registry<xyco::io::epoll::IoRegistry>();
+  }
+  if (driver.has_registry<xyco::io::epoll::LocalIoRegistry>()) {
+    return driver.registry<xyco::io::epoll::LocalIoRegistry>();
+  }
+  return std::unexpected(
+      xyco::utils::Error{.errno_ = ENXIO, .info_ = "no epoll registry on this worker"});
+}
+
 auto xyco::net::epoll::TcpSocket::bind(SocketAddr addr) -> Future<utils::Result<void>> {
   auto bind_result = co_await task::BlockingTask([&]() {
     return utils::into_sys_result(
@@ -37,10 +55,13 @@ auto xyco::net::epoll::TcpSocket::connect(SocketAddr addr) -> Future<utils::Resu
   // NOLINTNEXTLINE(cppcoreguidelines-avoid-reference-coroutine-parameters)
   class Future : public runtime::Future<CoOutput> {
    public:
-    explicit Future(SocketAddr addr, gsl::not_null<Socket *> socket)
+    explicit Future(SocketAddr addr,
+                    gsl::not_null<Socket *> socket,
+                    std::shared_ptr<runtime::Registry> registry)
         : runtime::Future<CoOutput>(nullptr),
           socket_(socket),
           addr_(addr),
+          registry_(std::move(registry)),
           event_(std::make_shared<runtime::Event>(runtime::Event{
               .future_ = this,
               .extra_ = std::make_unique<io::epoll::IoExtra>(io::epoll::IoExtra::Interest::Write,
@@ -48,8 +69,7 @@ auto xyco::net::epoll::TcpSocket::connect(SocketAddr addr) -> Future<utils::Resu
 
     auto poll([[maybe_unused]] runtime::Handle<void> self) -> runtime::Poll<CoOutput> override {
       auto *extra = dynamic_cast<io::epoll::IoExtra *>(event_->extra_.get());
-      if (extra->state_.get_field<io::epoll::IoExtra::State::Error>() ||
-          extra->state_.get_field<io::epoll::IoExtra::State::Writable>()) {
+      if (extra->state_.get_field<io::epoll::IoExtra::State::Registered>()) {
         int ret = -1;
         xyco::libc::socklen_t len = sizeof(decltype(ret));
         xyco::libc::getsockopt(socket_->into_c_fd(),
@@ -57,52 +77,59 @@ auto xyco::net::epoll::TcpSocket::connect(SocketAddr addr) -> Future<utils::Resu
                                xyco::libc::K_SO_ERROR,
                                &ret,
                                &len);
+        *registry_->deregister(event_);
         if (ret != 0) {
-          runtime::RuntimeCtx::get_ctx()->driver().deregister<io::epoll::IoRegistry>(event_);
           return runtime::Ready<CoOutput>{std::unexpected(
               utils::Error{.errno_ = ret, .info_ = strerror_l(ret, ::uselocale(nullptr))})};
         }
         logging::info("{} connect to {}", *socket_, addr_);
-        runtime::RuntimeCtx::get_ctx()->driver().deregister<io::epoll::IoRegistry>(event_);
-        return runtime::Ready<CoOutput>{
-            TcpStream(std::move(*socket_),
-                      extra->state_.get_field<io::epoll::IoExtra::State::Writable>(),
-                      extra->state_.get_field<io::epoll::IoExtra::State::Readable>())};
+        return runtime::Ready<CoOutput>{TcpStream(std::move(*socket_), registry_)};
       }
       event_->future_ = this;
-      runtime::RuntimeCtx::get_ctx()->driver().Register<io::epoll::IoRegistry>(event_);
+      *registry_->Register(event_);
       return runtime::Pending();
     }
 
    private:
     gsl::not_null<Socket *> socket_;
     SocketAddr addr_;
+    std::shared_ptr<runtime::Registry> registry_;
     std::shared_ptr<runtime::Event> event_;
   };
 
+  // Captured before the first suspension point, since blocking tasks may resume
+  // this coroutine on another worker.
+  auto registry = io_registry();
+  if (!registry) {
+    co_return std::unexpected(registry.error());
+  }
   auto connect_result = co_await task::BlockingTask([&]() {
     return utils::into_sys_result(
         xyco::libc::connect(socket_.into_c_fd(), addr.into_c_addr(), sizeof(xyco::libc::sockaddr)));
   });
   if (connect_result) {
-    co_return TcpStream(std::move(socket_), true);
+    co_return TcpStream(std::move(socket_), *std::move(registry));
   }
   auto err = connect_result.error().errno_;
   if (err != EINPROGRESS && err != EAGAIN) {
     logging::warn("{} connect fail{{errno={}}}", socket_, errno);
     co_return std::unexpected(utils::Error{.errno_ = err, .info_ = ""});
   }
-  co_return co_await Future(addr, &socket_);
+  co_return co_await Future(addr, &socket_, *std::move(registry));
 }
 
 auto xyco::net::epoll::TcpSocket::listen(int backlog) -> Future<utils::Result<TcpListener>> {
+  auto registry = io_registry();
+  if (!registry) {
+    co_return std::unexpected(registry.error());
+  }
   auto listen_result = co_await task::BlockingTask(
       [&]() { return utils::into_sys_result(xyco::libc::listen(socket_.into_c_fd(), backlog)); });
-  ASYNC_TRY(
-      listen_result.transform([&]([[maybe_unused]] auto n) { return TcpListener(Socket(-1)); }));
+  ASYNC_TRY(listen_result.transform(
+      [&]([[maybe_unused]] auto n) { return TcpListener(Socket(-1), nullptr); }));
   logging::info("{} listening", socket_);
 
-  co_return TcpListener(std::move(socket_));
+  co_return TcpListener(std::move(socket_), *std::move(registry));
 }
 
 auto xyco::net::epoll::TcpSocket::set_reuseaddr(bool reuseaddr) -> utils::Result<void> {
@@ -147,9 +174,177 @@ auto xyco::net::epoll::TcpStream::connect(SocketAddr addr) -> Future<utils::Resu
   co_return co_await socket->connect(addr);
 }
 
+auto xyco::net::epoll::TcpStream::read_vectored(std::span<const xyco::libc::iovec> iovecs)
+    -> Future<utils::Result<uintptr_t>> {
+  using CoOutput = utils::Result<uintptr_t>;
+
+  class Future : public runtime::Future<CoOutput> {
+   public:
+    auto poll([[maybe_unused]] runtime::Handle<void> self) -> runtime::Poll<CoOutput> override {
+      auto read_bytes = xyco::libc::readv(
+          self_->socket_.into_c_fd(), iovecs_.data(), static_cast<int>(iovecs_.size()));
+      auto would_block = read_bytes == -1 && (errno == EAGAIN || errno == EWOULDBLOCK);
+      if (std::exchange(first_poll_, false)) {
+        io::epoll::FastPathCounter::record(!would_block);
+      }
+      if (read_bytes != -1) {
+        logging::info("readv {} bytes from {}", read_bytes, *self_);
+        return runtime::Ready<CoOutput>{read_bytes};
+      }
+      if (!would_block) {
+        return runtime::Ready<CoOutput>{utils::into_sys_result(-1).transform(
+            []([[maybe_unused]] auto value) { return -1; })};
+      }
+      self_->wait_for(io::epoll::IoExtra::Interest::Read, this);
+      return runtime::Pending();
+    }
+
+    Future(std::span<const xyco::libc::iovec> iovecs, TcpStream *self)
+        : runtime::Future<CoOutput>(nullptr),
+          self_(self),
+          iovecs_(iovecs) {}
+
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-reference-coroutine-parameters)
+    Future(const Future &future) = delete;
+
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-reference-coroutine-parameters)
+    Future(Future &&future) = delete;
+
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-reference-coroutine-parameters)
+    auto operator=(Future &&future) -> Future & = delete;
+
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-reference-coroutine-parameters)
+    auto operator=(const Future &future) -> Future & = delete;
+
+    ~Future() override { self_->event_->future_ = nullptr; }
+
+   private:
+    TcpStream *self_;
+    std::span<const xyco::libc::iovec> iovecs_;
+    bool first_poll_{true};
+  };
+
+  co_return co_await Future(iovecs, this);
+}
+
+auto xyco::net::epoll::TcpStream::write_vectored(std::span<const xyco::libc::iovec> iovecs)
+    -> Future<utils::Result<uintptr_t>> {
+  using CoOutput = utils::Result<uintptr_t>;
+
+  class Future : public runtime::Future<CoOutput> {
+   public:
+    auto poll([[maybe_unused]] runtime::Handle<void> self) -> runtime::Poll<CoOutput> override {
+      auto write_bytes = xyco::libc::writev(
+          self_->socket_.into_c_fd(), iovecs_.data(), static_cast<int>(iovecs_.size()));
+      auto would_block = write_bytes == -1 && (errno == EAGAIN || errno == EWOULDBLOCK);
+      if (std::exchange(first_poll_, false)) {
+        io::epoll::FastPathCounter::record(!would_block);
+      }
+      if (!would_block) {
+        auto nbytes = utils::into_sys_result(write_bytes).transform([](auto n) {
+          return static_cast<uintptr_t>(n);
+        });
+        logging::info("writev {} bytes to {}", write_bytes, self_->socket_);
+        return runtime::Ready<CoOutput>{nbytes};
+      }
+      self_->wait_for(io::epoll::IoExtra::Interest::Write, this);
+      return runtime::Pending();
+    }
+
+    Future(std::span<const xyco::libc::iovec> iovecs, TcpStream *self)
+        : runtime::Future<CoOutput>(nullptr),
+          self_(self),
+          iovecs_(iovecs) {}
+
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-reference-coroutine-parameters)
+    Future(const Future &future) = delete;
+
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-reference-coroutine-parameters)
+    Future(Future &&future) = delete;
+
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-reference-coroutine-parameters)
+    auto operator=(Future &&future) -> Future & = delete;
+
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-reference-coroutine-parameters)
+    auto operator=(const Future &future) -> Future & = delete;
+
+    ~Future() override { self_->event_->future_ = nullptr; }
+
+   private:
+    TcpStream *self_;
+    std::span<const xyco::libc::iovec> iovecs_;
+    bool first_poll_{true};
+  };
+
+  co_return co_await Future(iovecs, this);
+}
+
+auto xyco::net::epoll::TcpStream::send_file(int file_descriptor,
+                                            xyco::libc::off64_t offset,
+                                            size_t len) -> Future<utils::Result<uintptr_t>> {
+  using CoOutput = utils::Result<uintptr_t>;
+
+  class Future : public runtime::Future<CoOutput> {
+   public:
+    auto poll([[maybe_unused]] runtime::Handle<void> self) -> runtime::Poll<CoOutput> override {
+      auto write_bytes =
+          xyco::libc::sendfile(self_->socket_.into_c_fd(), file_descriptor_, &offset_, len_);
+      auto would_block = write_bytes == -1 && (errno == EAGAIN || errno == EWOULDBLOCK);
+      if (std::exchange(first_poll_, false)) {
+        io::epoll::FastPathCounter::record(!would_block);
+      }
+      if (write_bytes != -1) {
+        logging::info("sendfile {} bytes to {}", write_bytes, self_->socket_);
+        return runtime::Ready<CoOutput>{write_bytes};
+      }
+      if (!would_block) {
+        return runtime::Ready<CoOutput>{utils::into_sys_result(-1).transform(
+            []([[maybe_unused]] auto value) { return -1; })};
+      }
+      self_->wait_for(io::epoll::IoExtra::Interest::Write, this);
+      return runtime::Pending();
+    }
+
+    Future(int file_descriptor, xyco::libc::off64_t offset, size_t len, TcpStream *self)
+        : runtime::Future<CoOutput>(nullptr),
+          self_(self),
+          file_descriptor_(file_descriptor),
+          offset_(offset),
+          len_(len) {}
+
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-reference-coroutine-parameters)
+    Future(const Future &future) = delete;
+
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-reference-coroutine-parameters)
+    Future(Future &&future) = delete;
+
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-reference-coroutine-parameters)
+    auto operator=(Future &&future) -> Future & = delete;
+
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-reference-coroutine-parameters)
+    auto operator=(const Future &future) -> Future & = delete;
+
+    ~Future() override { self_->event_->future_ = nullptr; }
+
+   private:
+    TcpStream *self_;
+    int file_descriptor_;
+    xyco::libc::off64_t offset_;
+    size_t len_;
+    bool first_poll_{true};
+  };
+
+  co_return co_await Future(file_descriptor, offset, len, this);
+}
+
 // NOLINTNEXTLINE(readability-convert-member-functions-to-static)
 auto xyco::net::epoll::TcpStream::flush() -> Future<utils::Result<void>> { co_return {}; }
 
+auto xyco::net::epoll::TcpStream::set_busy_poll(std::chrono::microseconds budget)
+    -> utils::Result<void> {
+  return socket_.set_busy_poll(budget);
+}
+
 auto xyco::net::epoll::TcpStream::shutdown(io::Shutdown shutdown) const
     -> Future<utils::Result<void>> {
   ASYNC_TRY((co_await task::BlockingTask([&]() {
@@ -162,27 +357,35 @@ auto xyco::net::epoll::TcpStream::shutdown(io::Shutdown shutdown) const
   co_return {};
 }
 
+auto xyco::net::epoll::TcpStream::wait_for(io::epoll::IoExtra::Interest interest,
+                                           runtime::FutureBase *future) -> void {
+  auto *extra = dynamic_cast<io::epoll::IoExtra *>(event_->extra_.get());
+  event_->future_ = future;
+  extra->interest_ = interest;
+  if (!extra->state_.get_field<io::epoll::IoExtra::State::Registered>()) {
+    logging::trace("register {}", *event_);
+    *registry_->Register(event_);
+  } else {
+    logging::trace("reregister {}", *event_);
+    *registry_->reregister(event_);
+  }
+}
+
 xyco::net::epoll::TcpStream::~TcpStream() {
   if (socket_.into_c_fd() != -1 &&
       dynamic_cast<io::epoll::IoExtra *>(event_->extra_.get())
           ->state_.get_field<io::epoll::IoExtra::State::Registered>()) {
-    runtime::RuntimeCtx::get_ctx()->driver().deregister<io::epoll::IoRegistry>(event_);
+    *registry_->deregister(event_);
   }
 }
 
-xyco::net::epoll::TcpStream::TcpStream(Socket &&socket, bool writable, bool readable)
+xyco::net::epoll::TcpStream::TcpStream(Socket &&socket,
+                                       std::shared_ptr<runtime::Registry> registry)
     : socket_(std::move(socket)),
+      registry_(std::move(registry)),
       event_(std::make_shared<runtime::Event>(runtime::Event{
           .extra_ = std::make_unique<io::epoll::IoExtra>(io::epoll::IoExtra::Interest::All,
-                                                         socket_.into_c_fd())})) {
-  auto &state = dynamic_cast<io::epoll::IoExtra *>(event_->extra_.get())->state_;
-  if (writable) {
-    state.set_field<io::epoll::IoExtra::State::Writable>();
-  }
-  if (readable) {
-    state.set_field<io::epoll::IoExtra::State::Readable>();
-  }
-}
+                                                         socket_.into_c_fd())})) {}
 
 auto xyco::net::epoll::TcpListener::bind(SocketAddr addr) -> Future<utils::Result<TcpListener>> {
   using runtime::Handle;
@@ -202,6 +405,40 @@ auto xyco::net::epoll::TcpListener::bind(SocketAddr addr) -> Future<utils::Resul
   co_return co_await tcp_socket.listen(max_pending_connection);
 }
 
+auto xyco::net::epoll::TcpListener::bind_per_worker(SocketAddr addr)
+    -> Future<utils::Result<TcpListener>> {
+  const int max_pending_connection = 128;
+
+  // Captures the worker before the first suspension point, since blocking tasks
+  // may resume this coroutine on another worker.
+  auto &driver = runtime::RuntimeCtx::get_ctx()->driver();
+  auto registry = driver.has_registry<io::epoll::LocalIoRegistry>()
+                      ? driver.registry<io::epoll::LocalIoRegistry>()
+                      : io_registry();
+  if (!registry) {
+    co_return std::unexpected(registry.error());
+  }
+
+  auto socket_result = TcpSocket::new_v4();
+  if (!socket_result) {
+    co_return std::unexpected(socket_result.error());
+  }
+  auto tcp_socket = *std::move(socket_result);
+  auto reuseport_result = tcp_socket.set_reuseport(true);
+  if (!reuseport_result) {
+    co_return std::unexpected(reuseport_result.error());
+  }
+  auto bind_result = co_await tcp_socket.bind(addr);
+  if (!bind_result) {
+    co_return std::unexpected(bind_result.error());
+  }
+  auto listener = co_await tcp_socket.listen(max_pending_connection);
+  if (listener) {
+    listener->registry_ = *std::move(registry);
+  }
+  co_return listener;
+}
+
 auto xyco::net::epoll::TcpListener::accept()
     -> Future<utils::Result<std::pair<TcpStream, SocketAddr>>> {
   using CoOutput = utils::Result<std::pair<TcpStream, SocketAddr>>;
@@ -209,52 +446,72 @@ auto xyco::net::epoll::TcpListener::accept()
   class Future : public runtime::Future<CoOutput> {
    public:
     auto poll([[maybe_unused]] runtime::Handle<void> self) -> runtime::Poll<CoOutput> override {
-      auto *extra = dynamic_cast<io::epoll::IoExtra *>(self_->event_->extra_.get());
-      if (!extra->state_.get_field<io::epoll::IoExtra::State::Registered>()) {
-        self_->event_->future_ = this;
-        runtime::RuntimeCtx::get_ctx()->driver().Register<io::epoll::IoRegistry>(self_->event_);
-        logging::trace("register accept {}", *self_->event_);
+      auto accept_result = self_->accept_nonblocking();
+      if (!accept_result && (accept_result.error().errno_ == EAGAIN ||
+                             accept_result.error().errno_ == EWOULDBLOCK)) {
+        self_->wait_readable(this);
         return runtime::Pending();
       }
-      if (extra->state_.get_field<io::epoll::IoExtra::State::Error>()) {
-        return runtime::Ready<CoOutput>{
-            std::unexpected(utils::Error{.errno_ = 1, .info_ = "epoll state error"})};
-      }
-      if (extra->state_.get_field<io::epoll::IoExtra::State::Readable>()) {
-        auto accept_result = utils::into_sys_result(
-            xyco::libc::accept4(self_->socket_.into_c_fd(),
-                                // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
-                                reinterpret_cast<xyco::libc::sockaddr *>(&addr_in_),
-                                &addrlen_,
-                                xyco::libc::K_SOCK_NONBLOCK));
-        if (!accept_result) {
-          auto err = accept_result.error();
-          if (err.errno_ == EAGAIN || err.errno_ == EWOULDBLOCK) {
-            self_->event_->future_ = this;
-            logging::trace("reregister accept {}", *self_->event_);
-            runtime::RuntimeCtx::get_ctx()->driver().reregister<io::epoll::IoRegistry>(
-                self_->event_);
-            return runtime::Pending();
-          }
+      return runtime::Ready<CoOutput>{std::move(accept_result)};
+    }
+
+    explicit Future(TcpListener *self) : runtime::Future<CoOutput>(nullptr), self_(self) {}
+
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-reference-coroutine-parameters)
+    Future(const Future &future) = delete;
+
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-reference-coroutine-parameters)
+    Future(Future &&future) = delete;
+
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-reference-coroutine-parameters)
+    auto operator=(Future &&future) -> Future & = delete;
+
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-reference-coroutine-parameters)
+    auto operator=(const Future &future) -> Future & = delete;
+
+    ~Future() override { self_->event_->future_ = nullptr; }
+
+   private:
+    TcpListener *self_;
+  };
+
+  co_return co_await Future(this);
+}
+
+auto xyco::net::epoll::TcpListener::accept_batch(size_t max_batch)
+    -> Future<utils::Result<std::vector<std::pair<TcpStream, SocketAddr>>>> {
+  using CoOutput = utils::Result<std::vector<std::pair<TcpStream, SocketAddr>>>;
+
+  class Future : public runtime::Future<CoOutput> {
+   public:
+    auto poll([[maybe_unused]] runtime::Handle<void> self) -> runtime::Poll<CoOutput> override {
+      std::vector<std::pair<TcpStream, SocketAddr>> batch;
+      while (batch.size() < max_batch_) {
+        auto accept_result = self_->accept_nonblocking();
+        if (accept_result) {
+          batch.push_back(*std::move(accept_result));
+          continue;
+        }
+        auto err = accept_result.error();
+        // Other errors are reported by the next call if some connections are
+        // already accepted.
+        if (err.errno_ != EAGAIN && err.errno_ != EWOULDBLOCK && batch.empty()) {
           return runtime::Ready<CoOutput>{std::unexpected(err)};
         }
-        std::string ip_addr(xyco::libc::K_INET_ADDRSTRLEN, 0);
-        auto sock_addr = SocketAddr::new_v4(Ipv4Addr(xyco::libc::inet_ntop(addr_in_.sin_family,
-                                                                           &addr_in_.sin_addr,
-                                                                           ip_addr.data(),
-                                                                           ip_addr.size())),
-                                            addr_in_.sin_port);
-        auto socket = Socket(*accept_result);
-        logging::info("accept from {} new connect={{{}, addr:{}}}",
-                      self_->socket_,
-                      socket,
-                      sock_addr);
-        return runtime::Ready<CoOutput>{std::pair{TcpStream(std::move(socket)), sock_addr}};
+        break;
       }
-      return runtime::Pending();
+      if (batch.empty()) {
+        self_->wait_readable(this);
+        return runtime::Pending();
+      }
+      logging::info("accept {} connections from {}", batch.size(), self_->socket_);
+      return runtime::Ready<CoOutput>{std::move(batch)};
     }
 
-    explicit Future(TcpListener *self) : runtime::Future<CoOutput>(nullptr), self_(self) {}
+    Future(size_t max_batch, TcpListener *self)
+        : runtime::Future<CoOutput>(nullptr),
+          self_(self),
+          max_batch_(max_batch) {}
 
     // NOLINTNEXTLINE(cppcoreguidelines-avoid-reference-coroutine-parameters)
     Future(const Future &future) = delete;
@@ -272,23 +529,63 @@ auto xyco::net::epoll::TcpListener::accept()
 
    private:
     TcpListener *self_;
-    xyco::libc::sockaddr_in addr_in_{};
-    xyco::libc::socklen_t addrlen_{sizeof(addr_in_)};
+    size_t max_batch_;
   };
 
-  co_return co_await Future(this);
+  if (max_batch == 0) {
+    co_return std::unexpected(utils::Error{.errno_ = EINVAL, .info_ = "empty accept batch"});
+  }
+  co_return co_await Future(max_batch, this);
+}
+
+auto xyco::net::epoll::TcpListener::accept_nonblocking()
+    -> utils::Result<std::pair<TcpStream, SocketAddr>> {
+  xyco::libc::sockaddr_in addr_in{};
+  xyco::libc::socklen_t addrlen{sizeof(addr_in)};
+  auto accept_result = utils::into_sys_result(
+      xyco::libc::accept4(socket_.into_c_fd(),
+                          // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+                          reinterpret_cast<xyco::libc::sockaddr *>(&addr_in),
+                          &addrlen,
+                          xyco::libc::K_SOCK_NONBLOCK | xyco::libc::K_SOCK_CLOEXEC));
+  if (!accept_result) {
+    return std::unexpected(accept_result.error());
+  }
+  std::string ip_addr(xyco::libc::K_INET_ADDRSTRLEN, 0);
+  auto sock_addr = SocketAddr::new_v4(Ipv4Addr(xyco::libc::inet_ntop(addr_in.sin_family,
+                                                                     &addr_in.sin_addr,
+                                                                     ip_addr.data(),
+                                                                     ip_addr.size())),
+                                      addr_in.sin_port);
+  auto socket = Socket(*accept_result);
+  logging::info("accept from {} new connect={{{}, addr:{}}}", socket_, socket, sock_addr);
+  return std::pair{TcpStream(std::move(socket), registry_), sock_addr};
+}
+
+auto xyco::net::epoll::TcpListener::wait_readable(runtime::FutureBase *future) -> void {
+  auto *extra = dynamic_cast<io::epoll::IoExtra *>(event_->extra_.get());
+  event_->future_ = future;
+  if (!extra->state_.get_field<io::epoll::IoExtra::State::Registered>()) {
+    logging::trace("register accept {}", *event_);
+    *registry_->Register(event_);
+  } else {
+    logging::trace("reregister accept {}", *event_);
+    *registry_->reregister(event_);
+  }
 }
 
 xyco::net::epoll::TcpListener::~TcpListener() {
   if (socket_.into_c_fd() != -1 && event_ != nullptr &&
       dynamic_cast<io::epoll::IoExtra *>(event_->extra_.get())
           ->state_.get_field<io::epoll::IoExtra::State::Registered>()) {
-    runtime::RuntimeCtx::get_ctx()->driver().deregister<io::epoll::IoRegistry>(event_);
+    *registry_->deregister(event_);
   }
 }
 
-xyco::net::epoll::TcpListener::TcpListener(Socket &&socket)
+xyco::net::epoll::TcpListener::TcpListener(Socket &&socket,
+                                           std::shared_ptr<runtime::Registry> registry)
     : socket_(std::move(socket)),
+      registry_(std::move(registry)),
       event_(std::make_shared<runtime::Event>(runtime::Event{
           .extra_ = std::make_unique<io::epoll::IoExtra>(io::epoll::IoExtra::Interest::Read,
                                                          socket_.into_c_fd())})) {}
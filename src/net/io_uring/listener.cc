@@ -1,8 +1,13 @@
 module;
 
+#include <algorithm>
+#include <array>
 #include <coroutine>
 #include <expected>
 #include <gsl/pointers>
+#include <limits>
+#include <span>
+#include <utility>
 #include <variant>
 
 #include "xyco/utils/result.h"
@@ -16,6 +21,72 @@ import xyco.libc;
 template <typename T>
 using Future = xyco::runtime::Future<T>;
 
+namespace {
+auto register_event(std::shared_ptr<xyco::runtime::Event> event) -> void {
+  xyco::runtime::RuntimeCtx::get_ctx()->driver().Register<xyco::io::uring::IoRegistry>(
+      std::move(event));
+}
+
+// Moves at most `len` bytes from `fd_in` to `fd_out`, one of which must be a pipe.
+auto splice_once(int fd_in, int64_t off_in, int fd_out, size_t len)
+    -> Future<xyco::utils::Result<uintptr_t>> {
+  using CoOutput = xyco::utils::Result<uintptr_t>;
+
+  class Future : public xyco::runtime::Future<CoOutput> {
+   public:
+    auto poll([[maybe_unused]] xyco::runtime::Handle<void> self)
+        -> xyco::runtime::Poll<CoOutput> override {
+      auto *extra = dynamic_cast<xyco::io::uring::IoExtra *>(event_->extra_.get());
+      if (!extra->state_.get_field<xyco::io::uring::IoExtra::State::Completed>()) {
+        event_->future_ = this;
+        xyco::runtime::RuntimeCtx::get_ctx()->driver().Register<xyco::io::uring::IoRegistry>(
+            event_);
+        return xyco::runtime::Pending();
+      }
+      extra->state_.set_field<xyco::io::uring::IoExtra::State::Completed, false>();
+      if (extra->return_ >= 0) {
+        return xyco::runtime::Ready<CoOutput>{extra->return_};
+      }
+      return xyco::runtime::Ready<CoOutput>{
+          std::unexpected(xyco::utils::Error{.errno_ = -extra->return_, .info_ = ""})};
+    }
+
+    Future(int fd_in, int64_t off_in, int fd_out, size_t len)
+        : xyco::runtime::Future<CoOutput>(nullptr),
+          event_(std::make_shared<xyco::runtime::Event>(
+              xyco::runtime::Event{.extra_ = std::make_unique<xyco::io::uring::IoExtra>()})) {
+      auto *extra = dynamic_cast<xyco::io::uring::IoExtra *>(event_->extra_.get());
+      extra->fd_ = fd_out;
+      extra->args_ = xyco::io::uring::IoExtra::Splice{
+          .fd_in_ = fd_in,
+          .off_in_ = off_in,
+          .len_ = static_cast<unsigned int>(
+              std::min<size_t>(len, std::numeric_limits<unsigned int>::max())),
+          .flags_ = xyco::libc::K_SPLICE_F_MOVE};
+    }
+
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-reference-coroutine-parameters)
+    Future(const Future &future) = delete;
+
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-reference-coroutine-parameters)
+    Future(Future &&future) = delete;
+
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-reference-coroutine-parameters)
+    auto operator=(Future &&future) -> Future & = delete;
+
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-reference-coroutine-parameters)
+    auto operator=(const Future &future) -> Future & = delete;
+
+    ~Future() override = default;
+
+   private:
+    std::shared_ptr<xyco::runtime::Event> event_;
+  };
+
+  co_return co_await Future(fd_in, off_in, fd_out, len);
+}
+}  // namespace
+
 auto xyco::net::uring::TcpSocket::bind(SocketAddr addr) -> Future<utils::Result<void>> {
   auto bind_result = co_await task::BlockingTask([&]() {
     return utils::into_sys_result(
@@ -123,9 +194,84 @@ auto xyco::net::uring::TcpStream::connect(SocketAddr addr) -> Future<utils::Resu
   co_return co_await socket->connect(addr);
 }
 
+auto xyco::net::uring::TcpStream::read_vectored(std::span<const xyco::libc::iovec> iovecs)
+    -> Future<utils::Result<uintptr_t>> {
+  co_return co_await io::uring::TransferFuture(
+      event_,
+      io::uring::IoExtra::Readv{.iovecs_ = iovecs.data(),
+                                .nr_vecs_ = static_cast<unsigned int>(iovecs.size())},
+      register_event);
+}
+
+auto xyco::net::uring::TcpStream::write_vectored(std::span<const xyco::libc::iovec> iovecs)
+    -> Future<utils::Result<uintptr_t>> {
+  co_return co_await io::uring::TransferFuture(
+      event_,
+      io::uring::IoExtra::Writev{.iovecs_ = iovecs.data(),
+                                 .nr_vecs_ = static_cast<unsigned int>(iovecs.size())},
+      register_event);
+}
+
+auto xyco::net::uring::TcpStream::send_file(int file_descriptor,
+                                            xyco::libc::off64_t offset,
+                                            size_t len) -> Future<utils::Result<uintptr_t>> {
+  // `IORING_OP_SPLICE` requires one side to be a pipe, so bytes go from the
+  // page cache to the pipe and then to the socket without entering user space.
+  if (!pipe_) {
+    auto pipe = Pipe::create();
+    if (!pipe) {
+      co_return std::unexpected(pipe.error());
+    }
+    pipe_ = std::move(*pipe);
+  }
+  auto pipe_read = pipe_->read_end();
+  auto pipe_write = pipe_->write_end();
+
+  uintptr_t total_nbytes = 0;
+  uintptr_t pipe_nbytes = 0;
+  utils::Result<uintptr_t> result;
+  while (total_nbytes < len) {
+    result = co_await splice_once(file_descriptor,
+                                  static_cast<int64_t>(offset + total_nbytes),
+                                  pipe_write,
+                                  len - total_nbytes);
+    if (!result || *result == 0) {
+      break;
+    }
+    pipe_nbytes = *result;
+    while (pipe_nbytes != 0) {
+      result = co_await splice_once(pipe_read, -1, socket_.into_c_fd(), pipe_nbytes);
+      if (!result) {
+        break;
+      }
+      pipe_nbytes -= *result;
+      total_nbytes += *result;
+    }
+    if (!result) {
+      break;
+    }
+  }
+  // Bytes left in the pipe by a failed send must not precede the next one.
+  if (pipe_nbytes != 0) {
+    pipe_.reset();
+  }
+
+  // Bytes already sent are reported first and the error surfaces on the next call.
+  if (!result && total_nbytes == 0) {
+    co_return std::unexpected(result.error());
+  }
+  logging::info("splice {} bytes to {}", total_nbytes, socket_);
+  co_return total_nbytes;
+}
+
 // NOLINTNEXTLINE(readability-convert-member-functions-to-static)
 auto xyco::net::uring::TcpStream::flush() -> Future<utils::Result<void>> { co_return {}; }
 
+auto xyco::net::uring::TcpStream::set_busy_poll(std::chrono::microseconds budget)
+    -> utils::Result<void> {
+  return socket_.set_busy_poll(budget);
+}
+
 auto xyco::net::uring::TcpStream::shutdown(io::Shutdown shutdown) -> Future<utils::Result<void>> {
   using CoOutput = utils::Result<void>;
 
@@ -167,6 +313,27 @@ auto xyco::net::uring::TcpStream::shutdown(io::Shutdown shutdown) -> Future<util
   co_return result;
 }
 
+auto xyco::net::uring::TcpStream::Pipe::create() -> utils::Result<Pipe> {
+  std::array<int, 2> fds{};
+  return utils::into_sys_result(xyco::libc::pipe2(fds.data(), xyco::libc::K_O_CLOEXEC))
+      .transform([&]([[maybe_unused]] auto n) { return Pipe(fds); });
+}
+
+xyco::net::uring::TcpStream::Pipe::Pipe(Pipe &&pipe) noexcept { *this = std::move(pipe); }
+
+auto xyco::net::uring::TcpStream::Pipe::operator=(Pipe &&pipe) noexcept -> Pipe & {
+  std::swap(fds_, pipe.fds_);
+  return *this;
+}
+
+xyco::net::uring::TcpStream::Pipe::~Pipe() {
+  for (auto file_descriptor : fds_) {
+    if (file_descriptor != -1) {
+      xyco::libc::close(file_descriptor);
+    }
+  }
+}
+
 xyco::net::uring::TcpStream::TcpStream(Socket &&socket)
     : socket_(std::move(socket)),
       event_(std::make_shared<runtime::Event>(
@@ -193,6 +360,26 @@ auto xyco::net::uring::TcpListener::bind(SocketAddr addr) -> Future<utils::Resul
   co_return co_await tcp_socket.listen(max_pending_connection);
 }
 
+auto xyco::net::uring::TcpListener::bind_per_worker(SocketAddr addr)
+    -> Future<utils::Result<TcpListener>> {
+  const int max_pending_connection = 128;
+
+  auto socket_result = TcpSocket::new_v4();
+  if (!socket_result) {
+    co_return std::unexpected(socket_result.error());
+  }
+  auto tcp_socket = *std::move(socket_result);
+  auto reuseport_result = tcp_socket.set_reuseport(true);
+  if (!reuseport_result) {
+    co_return std::unexpected(reuseport_result.error());
+  }
+  auto bind_result = co_await tcp_socket.bind(addr);
+  if (!bind_result) {
+    co_return std::unexpected(bind_result.error());
+  }
+  co_return co_await tcp_socket.listen(max_pending_connection);
+}
+
 auto xyco::net::uring::TcpListener::accept()
     -> Future<utils::Result<std::pair<TcpStream, SocketAddr>>> {
   using CoOutput = utils::Result<std::pair<TcpStream, SocketAddr>>;
@@ -257,6 +444,18 @@ auto xyco::net::uring::TcpListener::accept()
   co_return co_await Future(this);
 }
 
+auto xyco::net::uring::TcpListener::accept_batch(size_t max_batch)
+    -> Future<utils::Result<std::vector<std::pair<TcpStream, SocketAddr>>>> {
+  if (max_batch == 0) {
+    co_return std::unexpected(utils::Error{.errno_ = EINVAL, .info_ = "empty accept batch"});
+  }
+  co_return (co_await accept()).transform([](auto connection) {
+    std::vector<std::pair<TcpStream, SocketAddr>> batch;
+    batch.push_back(std::move(connection));
+    return batch;
+  });
+}
+
 xyco::net::uring::TcpListener::TcpListener(Socket &&socket)
     : socket_(std::move(socket)),
       event_(std::make_shared<runtime::Event>(
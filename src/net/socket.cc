@@ -1,5 +1,7 @@
 module;
 
+#include <chrono>
+#include <expected>
 #include <variant>
 
 module xyco.net.common;
@@ -62,6 +64,23 @@ auto xyco::net::SocketAddr::into_c_addr() const -> const xyco::libc::sockaddr* {
 
 auto xyco::net::Socket::into_c_fd() const -> int { return fd_; }
 
+auto xyco::net::Socket::set_busy_poll(std::chrono::microseconds budget) const
+    -> utils::Result<void> {
+  int busy_poll = static_cast<int>(budget.count());
+  auto busy_poll_result = utils::into_sys_result(xyco::libc::setsockopt(
+      fd_, xyco::libc::K_SOL_SOCKET, xyco::libc::K_SO_BUSY_POLL, &busy_poll, sizeof(busy_poll)));
+  if (!busy_poll_result) {
+    return std::unexpected(busy_poll_result.error());
+  }
+  int prefer_busy_poll = static_cast<int>(budget.count() > 0);
+  return utils::into_sys_result(xyco::libc::setsockopt(fd_,
+                                                       xyco::libc::K_SOL_SOCKET,
+                                                       xyco::libc::K_SO_PREFER_BUSY_POLL,
+                                                       &prefer_busy_poll,
+                                                       sizeof(prefer_busy_poll)))
+      .transform([]([[maybe_unused]] auto result) {});
+}
+
 xyco::net::Socket::Socket(int file_descriptor) : fd_(file_descriptor) {}
 
 xyco::net::Socket::Socket(Socket&& socket) noexcept : fd_(socket.fd_) { socket.fd_ = -1; }
@@ -11,9 +11,11 @@ module xyco.runtime_core;
 import xyco.logging;
 
 auto xyco::runtime::Worker::run_in_place(RuntimeCore *core) -> void {
+  core->driver_.start_running();
   while (!suspend_flag_) {
     run_loop_once(core);
   }
+  core->driver_.stop_running();
   suspend_flag_ = false;
 }
 
@@ -94,12 +96,22 @@ auto xyco::runtime::Worker::run_loop_once(RuntimeCore *core) -> void {
 }
 
 auto xyco::runtime::RuntimeCore::register_future(FutureBase *future) -> void {
-  std::scoped_lock<std::mutex> lock_guard(handle_mutex_);
-  handles_.emplace(handles_.begin(), future->get_handle(), future);
+  {
+    std::scoped_lock<std::mutex> lock_guard(handle_mutex_);
+    handles_.emplace(handles_.begin(), future->get_handle(), future);
+  }
+  // The future may be resumed by any worker, so kick an idle one if no other
+  // worker is around to take it before its select timeout.
+  driver_.wake_up_one();
 }
 
 auto xyco::runtime::RuntimeCore::driver() -> Driver & { return driver_; }
 
+auto xyco::runtime::RuntimeCore::has_global_handles() -> bool {
+  std::scoped_lock<std::mutex> lock_guard(handle_mutex_);
+  return !handles_.empty();
+}
+
 auto xyco::runtime::RuntimeCore::wake(Events &events) -> void {
   for (auto &event_ptr : events) {
     logging::trace("wake {}", *event_ptr);
@@ -109,21 +121,38 @@ auto xyco::runtime::RuntimeCore::wake(Events &events) -> void {
     std::scoped_lock<std::mutex> lock_guard(handle_mutex_);
     handles_.emplace(handles_.begin(), future->get_handle(), future);
   }
+  // Any worker may resume them, so an idle one is kicked to share the load.
+  if (!events.empty()) {
+    driver_.wake_up_one();
+  }
   events.clear();
 }
 
 auto xyco::runtime::RuntimeCore::wake_local(Events &events) -> void {
-  auto &worker = workers_.find(std::this_thread::get_id())->second;
+  auto &worker = current_worker();
   for (auto &event_ptr : events) {
     logging::trace("wake local {}", *event_ptr);
     auto *future = event_ptr->future_;
     event_ptr->future_ = nullptr;
-    std::scoped_lock<std::mutex> lock_guard(worker->handle_mutex_);
-    worker->handles_.emplace(worker->handles_.begin(), future->get_handle(), future);
+    std::scoped_lock<std::mutex> lock_guard(worker.handle_mutex_);
+    worker.handles_.emplace(worker.handles_.begin(), future->get_handle(), future);
   }
   events.clear();
 }
 
+auto xyco::runtime::RuntimeCore::current_worker() -> Worker & {
+  auto worker = workers_.find(std::this_thread::get_id());
+  return worker != workers_.end() ? *worker->second : in_place_worker_;
+}
+
+auto xyco::runtime::RuntimeCore::spawn_on(Worker &worker, Future<void> future) -> void {
+  auto handle = future.get_handle();
+  if (handle) {
+    std::scoped_lock<std::mutex> lock_guard(worker.handle_mutex_);
+    worker.handles_.insert(worker.handles_.begin(), {handle, nullptr});
+  }
+}
+
 xyco::runtime::RuntimeCore::RuntimeCore(
     std::vector<std::function<void(Driver *)>> &&registry_initializers,
     uint16_t worker_num)
@@ -1,23 +1,93 @@
 module;
 
+#include <atomic>
+#include <chrono>
 #include <thread>
 
 module xyco.runtime_core;
 
+import xyco.logging;
+
 auto xyco::runtime::Driver::poll() -> void {
   runtime::Events events;
 
   auto& local_registry = local_registries_.find(std::this_thread::get_id())->second;
+  auto& polling = polling_.find(std::this_thread::get_id())->second;
+  std::chrono::milliseconds timeout = MAX_TIMEOUT;
+  polling = true;
+  running_--;
+  // A future queued while this worker still counted as running skipped the
+  // kick, so it is taken without blocking.
+  if (RuntimeCtxImpl::get_ctx()->has_global_handles()) {
+    timeout = std::chrono::milliseconds(0);
+  }
   for (auto& [key, registry] : local_registry) {
-    *registry->select(events, MAX_TIMEOUT);
-    RuntimeCtxImpl::get_ctx()->wake(events);
+    *registry->select(events, timeout);
+    if (registry->wakes_locally()) {
+      RuntimeCtxImpl::get_ctx()->wake_local(events);
+    } else {
+      RuntimeCtxImpl::get_ctx()->wake(events);
+    }
+  }
+  running_++;
+  polling = false;
+}
+
+auto xyco::runtime::Driver::wake_up_one() -> void {
+  auto current_registry = local_registries_.find(std::this_thread::get_id());
+  // Only workers own registries able to interrupt their peers.
+  if (current_registry == local_registries_.end()) {
+    return;
+  }
+  // Pairs with `poll` checking the global queue after leaving `running_`, so
+  // either it sees the future queued before this call or this call sees it
+  // polling.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  // The current worker is not counted while it wakes futures from `poll`, nor
+  // outside its loop.
+  auto self_running = running_threads_.find(std::this_thread::get_id())->second &&
+                      !polling_.find(std::this_thread::get_id())->second;
+  auto others_running = running_ - (self_running ? 1 : 0);
+  if (others_running > 0) {
+    return;
+  }
+
+  for (auto& [thread_id, polling] : polling_) {
+    if (thread_id == std::this_thread::get_id() || !polling.exchange(false)) {
+      continue;
+    }
+    auto& peer_registry = local_registries_.find(thread_id)->second;
+    for (auto& [key, registry] : current_registry->second) {
+      auto peer = peer_registry.find(key);
+      // `GlobalRegistry` instances are shared by all workers and have no peer.
+      if (peer != peer_registry.end() && peer->second != registry) {
+        auto wake_up_result = registry->wake_up(*peer->second);
+        if (!wake_up_result) {
+          // The peer still wakes at its select timeout.
+          logging::warn("wake up peer fail{{errno={}}}", wake_up_result.error().errno_);
+        }
+      }
+    }
+    return;
   }
 }
 
 auto xyco::runtime::Driver::add_thread() -> void {
   local_registries_[std::this_thread::get_id()] =
       std::remove_reference_t<decltype(local_registries_[std::this_thread::get_id()])>();
+  polling_[std::this_thread::get_id()] = false;
+  running_threads_[std::this_thread::get_id()] = false;
   for (auto& registry_init : registry_initializers_) {
     registry_init(this);
   }
 }
+
+auto xyco::runtime::Driver::start_running() -> void {
+  running_threads_.find(std::this_thread::get_id())->second = true;
+  running_++;
+}
+
+auto xyco::runtime::Driver::stop_running() -> void {
+  running_--;
+  running_threads_.find(std::this_thread::get_id())->second = false;
+}
@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+
+#include <cerrno>
+#include <coroutine>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <string>
+
+import xyco.test.utils;
+import xyco.fs;
+
+class ReadDirTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    std::filesystem::create_directory(dir_root_);
+    for (size_t i = 0; i < file_count_; i++) {
+      std::ofstream(std::filesystem::path(dir_root_) / std::to_string(i)) << i;
+    }
+    std::filesystem::create_directory(std::filesystem::path(dir_root_) / "subdir");
+  }
+
+  static void TearDownTestSuite() { std::filesystem::remove_all(dir_root_); }
+
+  static const char *dir_root_;
+
+  static constexpr size_t file_count_ = 1000;
+};
+
+const char *ReadDirTest::dir_root_ = "test_read_dir/";
+
+TEST_F(ReadDirTest, read_all_entries) {
+  TestRuntimeCtx::runtime()->block_on([&]() -> xyco::runtime::Future<void> {
+    // A small buffer forces many batches.
+    auto dir = *co_await xyco::fs::read_dir(dir_root_, {.buffer_size_ = 512});
+
+    std::set<std::string> names;
+    while (auto entry = *co_await dir.next()) {
+      names.insert(entry->file_name());
+      CO_ASSERT_EQ(entry->metadata().has_value(), false);
+    }
+
+    CO_ASSERT_EQ(names.size(), file_count_ + 1);
+    CO_ASSERT_EQ(names.contains("subdir"), true);
+    CO_ASSERT_EQ(names.contains("."), false);
+    CO_ASSERT_EQ((*co_await dir.next()).has_value(), false);
+  }());
+}
+
+TEST_F(ReadDirTest, read_metadata) {
+  TestRuntimeCtx::runtime()->block_on([&]() -> xyco::runtime::Future<void> {
+    auto dir = *co_await xyco::fs::read_dir(dir_root_, {.metadata_ = true});
+
+    while (auto entry = *co_await dir.next()) {
+      auto expected_type = entry->file_name() == "subdir" ? std::filesystem::file_type::directory
+                                                          : std::filesystem::file_type::regular;
+      CO_ASSERT_EQ(entry->metadata()->file_type(), expected_type);
+      if (expected_type == std::filesystem::file_type::regular) {
+        CO_ASSERT_EQ(entry->metadata()->size(), entry->file_name().string().size());
+      }
+    }
+  }());
+}
+
+TEST_F(ReadDirTest, read_nonexist_dir) {
+  TestRuntimeCtx::runtime()->block_on([&]() -> xyco::runtime::Future<void> {
+    auto result = co_await xyco::fs::read_dir("nonexist_dir");
+
+    CO_ASSERT_EQ(result.error().errno_, ENOENT);
+  }());
+}
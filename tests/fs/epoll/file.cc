@@ -0,0 +1,35 @@
+#include <gtest/gtest.h>
+
+#include <coroutine>
+#include <filesystem>
+#include <string>
+
+import xyco.test.utils;
+import xyco.fs;
+
+TEST(EpollFileTest, inline_read) {
+  TestRuntimeCtx::runtime()->block_on([]() -> xyco::runtime::Future<void> {
+    const char *path = "test_inline_read";
+
+    auto file = *co_await xyco::fs::epoll::OpenOptions()
+                     .read(true)
+                     .write(true)
+                     .create_new(true)
+                     .open(path);
+    auto write_content = std::string("abcd");
+    *co_await file.write(write_content.begin(), write_content.end());
+    *co_await file.seek(0, SEEK_SET);
+
+    // The written data is still in the page cache.
+    auto hits = xyco::fs::epoll::InlineReadCounter::hits();
+    auto read_content = std::string(write_content.size(), 0);
+    auto read_result = co_await file.read(read_content.begin(), read_content.end());
+
+    CO_ASSERT_EQ(*read_result, write_content.size());
+    CO_ASSERT_EQ(read_content, write_content);
+    CO_ASSERT_EQ(xyco::fs::epoll::InlineReadCounter::hits(), hits + 1);
+    CO_ASSERT_EQ(xyco::fs::epoll::InlineReadCounter::hit_rate() > 0, true);
+
+    std::filesystem::remove(path);
+  }());
+}
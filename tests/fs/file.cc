@@ -1,10 +1,14 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <array>
 #include <coroutine>
 #include <filesystem>
 
 import xyco.test.utils;
 import xyco.fs;
+import xyco.io;
+import xyco.libc;
 
 class FileTest : public ::testing::Test {
  protected:
@@ -209,6 +213,38 @@ TEST_F(FileTest, file_attr) {
   }());
 }
 
+TEST_F(FileTest, file_metadata) {
+  TestRuntimeCtx::runtime()->block_on([&]() -> xyco::runtime::Future<void> {
+    const char *path = "test_file_metadata";
+
+    auto file_path = (std::string(fs_root_).append(path));
+    auto file = *co_await xyco::fs::File::create(file_path);
+
+    auto metadata = *co_await file.metadata();
+    CO_ASSERT_EQ(metadata.size(), 0U);
+    CO_ASSERT_EQ(metadata.file_type(), std::filesystem::file_type::regular);
+
+    // Writes through the file drop the cached metadata.
+    auto write_content = std::string("abcd");
+    *co_await file.write(write_content.begin(), write_content.end());
+    CO_ASSERT_EQ(*co_await file.size(), write_content.size());
+
+    auto patch = std::string("efgh");
+    *co_await file.write_at(2, patch.begin(), patch.end());
+    CO_ASSERT_EQ(*co_await file.size(), 6U);
+
+    // Changes through another descriptor need a refresh.
+    auto other = *co_await xyco::fs::OpenOptions().write(true).open(file_path);
+    *co_await other.resize(8);
+    CO_ASSERT_EQ(*co_await file.size(), 6U);
+    metadata = *co_await file.refresh_metadata();
+    CO_ASSERT_EQ(metadata.size(), 8U);
+
+    *co_await xyco::fs::rename(file_path, file_path + "_renamed");
+    CO_ASSERT_EQ((co_await file.refresh_metadata()).has_value(), true);
+  }());
+}
+
 TEST_F(FileTest, set_file_permission) {
   TestRuntimeCtx::runtime()->block_on([&]() -> xyco::runtime::Future<void> {
     const char *path = "test_set_file_permission";
@@ -313,6 +349,150 @@ TEST_F(FileTest, copy_nonexist_file) {
   }());
 }
 
+TEST_F(FileTest, copy_file_progress) {
+  TestRuntimeCtx::runtime()->block_on([&]() -> xyco::runtime::Future<void> {
+    const char *path = "test_copy_file_progress";
+
+    auto file_path = std::string(fs_root_).append(path);
+    auto file = *co_await xyco::fs::File::create(file_path);
+    auto content = std::string("copy content");
+    *co_await file.write(content.begin(), content.end());
+
+    auto new_file_path = std::string(file_path).append("_copy");
+    uintmax_t copied = 0;
+    uintmax_t total = 0;
+    auto copy_result =
+        co_await xyco::fs::copy_file(file_path,
+                                     new_file_path,
+                                     std::filesystem::copy_options::none,
+                                     [&](uintmax_t progress_copied, uintmax_t progress_total) {
+                                       copied = progress_copied;
+                                       total = progress_total;
+                                     });
+
+    CO_ASSERT_EQ(*copy_result, true);
+    CO_ASSERT_EQ(copied, content.size());
+    CO_ASSERT_EQ(total, content.size());
+
+    auto new_file = *co_await xyco::fs::File::open(new_file_path);
+    auto read_content = std::string(content.size(), 0);
+    *co_await new_file.read(read_content.begin(), read_content.end());
+
+    CO_ASSERT_EQ(read_content, content);
+
+    auto skip_result = co_await xyco::fs::copy_file(
+        file_path, new_file_path, std::filesystem::copy_options::skip_existing);
+
+    CO_ASSERT_EQ(*skip_result, false);
+
+    auto exist_result = co_await xyco::fs::copy_file(file_path, new_file_path);
+
+    CO_ASSERT_EQ(exist_result.has_value(), false);
+  }());
+}
+
+TEST_F(FileTest, advise_file) {
+  TestRuntimeCtx::runtime()->block_on([&]() -> xyco::runtime::Future<void> {
+    const char *path = "test_advise_file";
+
+    auto file_path = std::string(fs_root_).append(path);
+    auto file =
+        *co_await xyco::fs::OpenOptions().read(true).write(true).create_new(true).open(file_path);
+    *co_await file.resize(4096);
+
+    for (auto advice : {xyco::io::Advice::Sequential,
+                        xyco::io::Advice::Random,
+                        xyco::io::Advice::WillNeed,
+                        xyco::io::Advice::DontNeed,
+                        xyco::io::Advice::Normal}) {
+      CO_ASSERT_EQ((co_await file.advise(advice)).has_value(), true);
+    }
+    CO_ASSERT_EQ((co_await file.readahead(0, 4096)).has_value(), true);
+  }());
+}
+
+TEST_F(FileTest, buffer_read_streaming_file) {
+  TestRuntimeCtx::runtime()->block_on([&]() -> xyco::runtime::Future<void> {
+    const char *path = "test_buffer_read_streaming_file";
+
+    auto file_path = std::string(fs_root_).append(path);
+    auto content = std::string(1024 * 1024, 0);
+    std::ranges::generate(content, [i = 0]() mutable { return static_cast<char>(i++ % 251); });
+    {
+      auto file = *co_await xyco::fs::File::create(file_path);
+      *co_await xyco::io::WriteExt::write_all(file, content);
+    }
+
+    auto file = *co_await xyco::fs::File::open(file_path);
+    auto reader = xyco::io::BufferReader<xyco::fs::File, std::string>(&file);
+    auto read_content =
+        co_await xyco::io::BufferReadExt::read_to_end<decltype(reader), std::string>(reader);
+
+    CO_ASSERT_EQ(*read_content == content, true);
+    // The buffer grows from 8 KB to its streaming maximum.
+    CO_ASSERT_EQ(reader.capacity(), 128 * 1024U);
+  }());
+}
+
+TEST_F(FileTest, read_ahead_file) {
+  TestRuntimeCtx::runtime()->block_on([&]() -> xyco::runtime::Future<void> {
+    const char *path = "test_read_ahead_file";
+
+    auto file_path = std::string(fs_root_).append(path);
+    auto content = std::string(100 * 1024, 0);
+    std::ranges::generate(content, [i = 0]() mutable { return static_cast<char>(i++ % 251); });
+    {
+      auto file = *co_await xyco::fs::File::create(file_path);
+      *co_await xyco::io::WriteExt::write_all(file, content);
+    }
+
+    auto file = *co_await xyco::fs::File::open(file_path);
+    auto reader = xyco::io::ReadAheadReader<xyco::fs::File, std::string>(&file, 4096);
+    auto head = std::string(10, 0);
+    auto read_result = co_await reader.read(head.begin(), head.end());
+
+    CO_ASSERT_EQ(*read_result, head.size());
+
+    auto rest =
+        co_await xyco::io::BufferReadExt::read_to_end<decltype(reader), std::string>(reader);
+
+    CO_ASSERT_EQ(head + *rest == content, true);
+  }());
+}
+
+TEST_F(FileTest, drop_read_ahead_reader) {
+  TestRuntimeCtx::runtime()->block_on([&]() -> xyco::runtime::Future<void> {
+    const char *path = "test_drop_read_ahead_reader";
+
+    auto file_path = std::string(fs_root_).append(path);
+    auto content = std::string(100 * 1024, 0);
+    std::ranges::generate(content, [i = 0]() mutable { return static_cast<char>(i++ % 251); });
+    {
+      auto file = *co_await xyco::fs::File::create(file_path);
+      *co_await xyco::io::WriteExt::write_all(file, content);
+    }
+
+    // The dropped reader's file stays open until the end of the test, so the second
+    // file never reuses its fd while the cancelled read may still be running.
+    auto dropped_file = *co_await xyco::fs::File::open(file_path);
+    {
+      auto reader = xyco::io::ReadAheadReader<xyco::fs::File, std::string>(&dropped_file, 4096);
+      auto head = std::string(10, 0);
+      auto read_result = co_await reader.read(head.begin(), head.end());
+
+      CO_ASSERT_EQ(*read_result, head.size());
+      // `reader` is dropped with the read of its next buffer in flight.
+    }
+
+    // The cancelled read must not touch the dropped reader while it ends.
+    auto file = *co_await xyco::fs::File::open(file_path);
+    auto reader = xyco::io::ReadAheadReader<xyco::fs::File, std::string>(&file, 4096);
+    auto all = co_await xyco::io::BufferReadExt::read_to_end<decltype(reader), std::string>(reader);
+
+    CO_ASSERT_EQ(*all == content, true);
+  }());
+}
+
 TEST_F(FileTest, operate_removed_file) {
   TestRuntimeCtx::runtime()->block_on([&]() -> xyco::runtime::Future<void> {
     const char *path = "test_operate_removed_file";
@@ -325,8 +505,9 @@ TEST_F(FileTest, operate_removed_file) {
     auto resize_result = co_await file.resize(4);
     CO_ASSERT_EQ(resize_result.has_value(), false);
 
+    // The metadata is fetched through the still open file descriptor.
     auto size_result = (co_await file.size());
-    CO_ASSERT_EQ(size_result.has_value(), false);
+    CO_ASSERT_EQ(*size_result, 0U);
 
     auto status_result = co_await file.status();
     CO_ASSERT_EQ(status_result.has_value(), false);
@@ -388,3 +569,121 @@ TEST_F(FileTest, flush) {
     CO_ASSERT_EQ(flush_result.has_value(), true);
   }());
 }
+
+TEST_F(FileTest, allocate) {
+  TestRuntimeCtx::runtime()->block_on([&]() -> xyco::runtime::Future<void> {
+    const char *path = "test_allocate";
+
+    auto file_path = (std::string(fs_root_).append(path));
+    auto file = *co_await xyco::fs::File::create(file_path);
+
+    auto allocate_result = co_await file.allocate(0, 8192, xyco::libc::K_FALLOC_FL_KEEP_SIZE);
+    CO_ASSERT_EQ(allocate_result.has_value(), true);
+    CO_ASSERT_EQ(*co_await file.size(), 0U);
+
+    allocate_result = co_await file.allocate(0, 4096);
+    CO_ASSERT_EQ(allocate_result.has_value(), true);
+    CO_ASSERT_EQ(*co_await file.size(), 4096U);
+  }());
+}
+
+TEST_F(FileTest, sync_data_and_range) {
+  TestRuntimeCtx::runtime()->block_on([&]() -> xyco::runtime::Future<void> {
+    const char *path = "test_sync_data_and_range";
+
+    auto file_path = (std::string(fs_root_).append(path));
+    auto file = *co_await xyco::fs::File::create(file_path);
+
+    auto write_content = std::string("abcd");
+    *co_await file.write(write_content.begin(), write_content.end());
+
+    CO_ASSERT_EQ((co_await file.sync_range(0, 0)).has_value(), true);
+    CO_ASSERT_EQ((co_await file.sync_data()).has_value(), true);
+  }());
+}
+
+TEST_F(FileTest, direct_rw_file) {
+  TestRuntimeCtx::runtime()->block_on([&]() -> xyco::runtime::Future<void> {
+    const char *path = "test_direct_rw_file";
+
+    auto file_path = (std::string(fs_root_).append(path));
+    auto open_result = co_await xyco::fs::OpenOptions()
+                           .read(true)
+                           .write(true)
+                           .create_new(true)
+                           .direct(true)
+                           .open(file_path);
+    // Skip filesystems without `O_DIRECT` support.
+    if (!open_result && open_result.error().errno_ == EINVAL) {
+      co_return;
+    }
+    auto file = std::move(*open_result);
+
+    auto write_content = xyco::fs::AlignedBuffer(1);
+    CO_ASSERT_EQ(write_content.size(), xyco::fs::AlignedBuffer::DEFAULT_ALIGNMENT);
+    std::fill(write_content.begin(), write_content.end(), 'a');
+    auto write_result = (co_await file.write(write_content.begin(), write_content.end()));
+
+    CO_ASSERT_EQ(*write_result, write_content.size());
+
+    *co_await file.seek(0, SEEK_SET);
+    auto read_content = xyco::fs::AlignedBuffer(write_content.size());
+    auto read_result = (co_await file.read(read_content.begin(), read_content.end()));
+
+    CO_ASSERT_EQ(*read_result, read_content.size());
+    CO_ASSERT_EQ(std::equal(read_content.begin(), read_content.end(), write_content.begin()), true);
+  }());
+}
+
+TEST_F(FileTest, rw_vectored_file) {
+  TestRuntimeCtx::runtime()->block_on([&]() -> xyco::runtime::Future<void> {
+    const char *path = "test_rw_vectored_file";
+
+    auto file_path = (std::string(fs_root_).append(path));
+    auto file =
+        *co_await xyco::fs::OpenOptions().read(true).write(true).create_new(true).open(file_path);
+
+    std::string header = "header";
+    std::string body = "body";
+    auto w_iovecs =
+        std::array{xyco::libc::iovec{.iov_base = header.data(), .iov_len = header.size()},
+                   xyco::libc::iovec{.iov_base = body.data(), .iov_len = body.size()}};
+    auto write_result = co_await xyco::io::WriteExt::write_all_vectored(file, w_iovecs);
+
+    CO_ASSERT_EQ(write_result.has_value(), true);
+
+    *co_await file.seek(0, SEEK_SET);
+    auto read_content = std::string(header.size() + body.size(), 0);
+    auto r_iovecs = std::array{
+        xyco::libc::iovec{.iov_base = read_content.data(), .iov_len = header.size()},
+        xyco::libc::iovec{.iov_base = read_content.data() + header.size(), .iov_len = body.size()}};
+    auto read_result = co_await file.read_vectored(r_iovecs);
+
+    CO_ASSERT_EQ(*read_result, read_content.size());
+    CO_ASSERT_EQ(read_content, header + body);
+  }());
+}
+
+TEST_F(FileTest, rw_at_file) {
+  TestRuntimeCtx::runtime()->block_on([&]() -> xyco::runtime::Future<void> {
+    const char *path = "test_rw_at_file";
+
+    auto file_path = (std::string(fs_root_).append(path));
+    auto file =
+        *co_await xyco::fs::OpenOptions().read(true).write(true).create_new(true).open(file_path);
+
+    auto write_content = std::string("abcd");
+    *co_await file.write(write_content.begin(), write_content.end());
+    auto patch = std::string("XY");
+    auto write_result = co_await file.write_at(2, patch.begin(), patch.end());
+
+    CO_ASSERT_EQ(*write_result, patch.size());
+
+    auto read_content = std::string(3, 0);
+    auto read_result = co_await file.read_at(1, read_content.begin(), read_content.end());
+
+    CO_ASSERT_EQ(*read_result, read_content.size());
+    CO_ASSERT_EQ(read_content, "bXY");
+    CO_ASSERT_EQ(*co_await file.seek(0, SEEK_CUR), 4);
+  }());
+}
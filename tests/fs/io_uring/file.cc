@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <coroutine>
+#include <filesystem>
+
+import xyco.test.utils;
+import xyco.runtime;
+import xyco.runtime_ctx;
+import xyco.task;
+import xyco.io;
+import xyco.fs;
+
+TEST(UringFileTest, direct_rw_on_polled_ring) {
+  // Direct reads and writes go to the polled ring instead of `IoRegistry`.
+  auto runtime = *xyco::runtime::Builder::new_multi_thread()
+                      .worker_threads(1)
+                      .registry<xyco::task::BlockingRegistry>(1)
+                      .registry<xyco::io::uring::IoRegistry>(4)
+                      .registry<xyco::io::uring::IoPollRegistry>(4)
+                      .build();
+  runtime->block_on([]() -> xyco::runtime::Future<void> {
+    const char *path = "test_direct_rw_on_polled_ring";
+
+    CO_ASSERT_EQ(xyco::runtime::RuntimeCtx::get_ctx()
+                     ->driver()
+                     .has_registry<xyco::io::uring::IoPollRegistry>(),
+                 true);
+
+    auto open_result = co_await xyco::fs::uring::OpenOptions()
+                           .read(true)
+                           .write(true)
+                           .create_new(true)
+                           .direct(true)
+                           .open(path);
+    // Skip filesystems without `O_DIRECT` support.
+    if (!open_result && open_result.error().errno_ == EINVAL) {
+      co_return;
+    }
+    auto file = std::move(*open_result);
+
+    auto write_content = xyco::fs::AlignedBuffer(1);
+    std::fill(write_content.begin(), write_content.end(), 'a');
+    auto write_result = co_await file.write(write_content.begin(), write_content.end());
+    // Skip devices which cannot be polled.
+    if (!write_result && write_result.error().errno_ == EOPNOTSUPP) {
+      std::filesystem::remove(path);
+      co_return;
+    }
+
+    CO_ASSERT_EQ(*write_result, write_content.size());
+
+    *co_await file.seek(0, SEEK_SET);
+    auto read_content = xyco::fs::AlignedBuffer(write_content.size());
+    auto read_result = co_await file.read(read_content.begin(), read_content.end());
+
+    CO_ASSERT_EQ(*read_result, read_content.size());
+    CO_ASSERT_EQ(std::equal(read_content.begin(), read_content.end(), write_content.begin()), true);
+
+    std::filesystem::remove(path);
+  }());
+}
@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <coroutine>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+import xyco.test.utils;
+import xyco.fs;
+import xyco.task;
+
+class LogWriterTest : public ::testing::Test {
+ protected:
+  void TearDown() override { std::filesystem::remove(path_); }
+
+  static auto record(char byte) -> std::vector<char> { return std::vector<char>(4, byte); }
+
+  const char *path_ = "test_log_writer";
+};
+
+TEST_F(LogWriterTest, group_commit) {
+  TestRuntimeCtx::runtime()->block_on([&]() -> xyco::runtime::Future<void> {
+    xyco::fs::LogWriter<xyco::fs::File> writer(*co_await xyco::fs::File::create(path_));
+
+    auto [first, second, third] = co_await xyco::task::join(
+        writer.append(record('a')), writer.append(record('b')), writer.append(record('c')));
+
+    CO_ASSERT_EQ(first.has_value(), true);
+    CO_ASSERT_EQ(second.has_value(), true);
+    CO_ASSERT_EQ(third.has_value(), true);
+    // The records appended during the first commit share the next one.
+    CO_ASSERT_EQ(writer.groups() < 3, true);
+
+    std::ifstream log(path_);
+    auto content = std::string(std::istreambuf_iterator<char>(log), {});
+    std::ranges::sort(content);
+    CO_ASSERT_EQ(content, "aaaabbbbcccc");
+  }());
+}
+
+TEST_F(LogWriterTest, append_in_order) {
+  TestRuntimeCtx::runtime()->block_on([&]() -> xyco::runtime::Future<void> {
+    xyco::fs::LogWriter<xyco::fs::File> writer(*co_await xyco::fs::File::create(path_));
+
+    for (auto byte : {'a', 'b', 'c'}) {
+      CO_ASSERT_EQ((co_await writer.append(record(byte))).has_value(), true);
+    }
+
+    CO_ASSERT_EQ(writer.groups(), 3U);
+    std::ifstream log(path_);
+    auto content = std::string(std::istreambuf_iterator<char>(log), {});
+    CO_ASSERT_EQ(content, "aaaabbbbcccc");
+  }());
+}
+
+TEST_F(LogWriterTest, append_error) {
+  TestRuntimeCtx::runtime()->block_on([&]() -> xyco::runtime::Future<void> {
+    CO_ASSERT_EQ((co_await xyco::fs::File::create(path_)).has_value(), true);
+    xyco::fs::LogWriter<xyco::fs::File> writer(*co_await xyco::fs::File::open(path_));
+
+    auto result = co_await writer.append(record('a'));
+
+    CO_ASSERT_EQ(result.error().errno_, EBADF);
+    CO_ASSERT_EQ(writer.groups(), 1U);
+  }());
+}
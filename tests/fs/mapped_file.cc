@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+
+#include <cerrno>
+#include <coroutine>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+import xyco.test.utils;
+import xyco.fs;
+
+class MappedFileTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    std::ofstream(path_) << content_;
+    std::ofstream(empty_path_);
+  }
+
+  void TearDown() override {
+    std::filesystem::remove(path_);
+    std::filesystem::remove(empty_path_);
+  }
+
+  const char *path_ = "test_mapped_file";
+  const char *empty_path_ = "test_empty_mapped_file";
+  std::string content_ = std::string(8192, 'a') + "lookup";
+};
+
+TEST_F(MappedFileTest, read_mapping) {
+  TestRuntimeCtx::runtime()->block_on([&]() -> xyco::runtime::Future<void> {
+    auto file = *co_await xyco::fs::MappedFile::open(path_);
+
+    CO_ASSERT_EQ(file.size(), content_.size());
+    CO_ASSERT_EQ(std::string(file.data().begin(), file.data().end()), content_);
+  }());
+}
+
+TEST_F(MappedFileTest, prefetch) {
+  TestRuntimeCtx::runtime()->block_on([&]() -> xyco::runtime::Future<void> {
+    auto file = *co_await xyco::fs::MappedFile::open(path_, xyco::fs::MappedFile::Prefetch::Advise);
+
+    CO_ASSERT_EQ((co_await file.advise(xyco::fs::MappedFile::Advice::Random)).has_value(), true);
+    CO_ASSERT_EQ((co_await file.prefetch(8190, 4)).has_value(), true);
+    CO_ASSERT_EQ((co_await file.prefetch(content_.size() + 1)).has_value(), false);
+    CO_ASSERT_EQ(std::string(file.data().subspan(8192).begin(), file.data().end()), "lookup");
+  }());
+}
+
+TEST_F(MappedFileTest, populate_empty_file) {
+  TestRuntimeCtx::runtime()->block_on([&]() -> xyco::runtime::Future<void> {
+    auto file =
+        *co_await xyco::fs::MappedFile::open(empty_path_, xyco::fs::MappedFile::Prefetch::Populate);
+
+    CO_ASSERT_EQ(file.size(), 0U);
+    CO_ASSERT_EQ((co_await file.prefetch()).has_value(), true);
+  }());
+}
+
+TEST_F(MappedFileTest, open_nonexist_file) {
+  TestRuntimeCtx::runtime()->block_on([&]() -> xyco::runtime::Future<void> {
+    auto result = co_await xyco::fs::MappedFile::open("nonexist_mapped_file");
+
+    CO_ASSERT_EQ(result.error().errno_, ENOENT);
+  }());
+}
@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <chrono>
+#include <coroutine>
+#include <memory>
+#include <tuple>
+
+import xyco.test.utils;
+import xyco.runtime_ctx;
+import xyco.io;
+import xyco.libc;
+
+TEST(BackendTest, probe_once) {
+  auto backend = xyco::io::backend();
+
+  // The test runtime has already chosen a backend.
+  ASSERT_FALSE(xyco::io::use_backend(backend == xyco::io::Backend::Epoll
+                                         ? xyco::io::Backend::IoUring
+                                         : xyco::io::Backend::Epoll));
+  ASSERT_EQ(xyco::io::backend(), backend);
+}
+
+TEST(BackendTest, add_registry_of_backend) {
+  auto [epoll, local_epoll, uring] = TestRuntimeCtx::runtime()->block_on(
+      []() -> xyco::runtime::Future<std::tuple<bool, bool, bool>> {
+        auto &driver = xyco::runtime::RuntimeCtx::get_ctx()->driver();
+        co_return std::tuple(driver.has_registry<xyco::io::epoll::IoRegistry>(),
+                             driver.has_registry<xyco::io::epoll::LocalIoRegistry>(),
+                             driver.has_registry<xyco::io::uring::IoRegistry>());
+      }());
+  auto backend = xyco::io::backend();
+
+  ASSERT_EQ(epoll, backend == xyco::io::Backend::Epoll);
+  // `Hybrid` serves files with a ring watched by the worker's own epoll.
+  ASSERT_EQ(local_epoll, backend == xyco::io::Backend::Hybrid);
+  ASSERT_EQ(uring,
+            backend == xyco::io::Backend::IoUring || backend == xyco::io::Backend::Hybrid);
+}
+
+TEST(BackendTest, hybrid_wait) {
+  std::array<int, 2> pipe{};
+  ASSERT_EQ(xyco::libc::pipe2(pipe.data(), 0), 0);
+  xyco::io::uring::IoRegistryImpl ring(4, xyco::io::uring::IoRegistryImpl::Wait::External);
+  xyco::io::epoll::IoRegistryImpl epoll(4);
+  ASSERT_TRUE(epoll.watch(ring.ring_fd()));
+
+  std::array<char, 1> buffer{};
+  auto event = std::make_shared<xyco::runtime::Event>(
+      xyco::runtime::Event{.extra_ = std::make_unique<xyco::io::uring::IoExtra>()});
+  auto *extra = dynamic_cast<xyco::io::uring::IoExtra *>(event->extra_.get());
+  extra->fd_ = pipe[0];
+  extra->args_ = xyco::io::uring::IoExtra::Read{.buf_ = buffer.data(), .len_ = 1};
+  ASSERT_TRUE(ring.Register(event));
+  ASSERT_EQ(xyco::libc::write(pipe[1], "x", 1), 1);
+
+  // The completion wakes the epoll wait and is reaped by the ring.
+  xyco::runtime::Events events;
+  while (events.empty()) {
+    ASSERT_TRUE(epoll.select(events, std::chrono::milliseconds(1)));
+    ASSERT_TRUE(events.empty());
+    ASSERT_TRUE(ring.select(events, std::chrono::milliseconds(1)));
+  }
+  ASSERT_EQ(events[0], event);
+  ASSERT_EQ(extra->return_, 1);
+
+  xyco::libc::close(pipe[0]);
+  xyco::libc::close(pipe[1]);
+}
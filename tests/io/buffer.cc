@@ -1,8 +1,16 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cerrno>
 #include <coroutine>
+#include <cstdint>
+#include <list>
+#include <ranges>
+#include <tuple>
+#include <vector>
 
 import xyco.test.utils;
+import xyco.runtime_core;
 import xyco.net;
 import xyco.io;
 
@@ -119,9 +127,7 @@ TEST_F(BufferTest, read_until_eof) {
         *co_await xyco::io::BufferReadExt::read_until<decltype(reader), std::string>(reader, 'c');
 
     CO_ASSERT_EQ(write_nbytes, write_bytes.size());
-    std::string expected_line(write_bytes);
-    expected_line.push_back('\0');
-    CO_ASSERT_EQ(line, expected_line);
+    CO_ASSERT_EQ(line, write_bytes);
   }(client_.get(), server_.get()));
 }
 
@@ -140,6 +146,41 @@ TEST_F(BufferTest, read_line) {
   }(client_.get(), server_.get()));
 }
 
+TEST_F(BufferTest, read_until_view) {
+  TestRuntimeCtx::runtime()->block_on([](xyco::net::TcpStream *client, xyco::net::TcpStream *server)
+                                          -> xyco::runtime::Future<void> {
+    *co_await xyco::io::WriteExt::write_all(*client, std::string_view("ab\ncd"));
+    *co_await client->shutdown(xyco::io::Shutdown::All);
+
+    xyco::io::BufferReader<xyco::net::TcpStream, std::string> reader(server, 4);
+    auto read_line = [&]() {
+      return xyco::io::BufferReadExt::read_until_view<decltype(reader), std::string>(reader, '\n');
+    };
+    auto [begin, end] = *co_await read_line();
+
+    CO_ASSERT_EQ(std::string(begin, end), "ab\n");
+
+    // "cd" straddles two reads and has no delimiter before the end.
+    std::tie(begin, end) = *co_await read_line();
+
+    CO_ASSERT_EQ(std::string(begin, end), "cd");
+
+    std::tie(begin, end) = *co_await read_line();
+
+    CO_ASSERT_EQ(begin == end, true);
+  }(client_.get(), server_.get()));
+}
+
+TEST(FindByteTest, find_byte) {
+  auto bytes = std::string(100, 'a');
+  bytes[70] = '\n';
+
+  ASSERT_EQ(xyco::io::find_byte(bytes.begin(), bytes.end(), '\n') - bytes.begin(), 70);
+  ASSERT_EQ(xyco::io::find_byte(bytes.begin(), bytes.begin() + 70, '\n'), bytes.begin() + 70);
+  auto list = std::list<char>(bytes.begin(), bytes.end());
+  ASSERT_EQ(std::distance(list.begin(), xyco::io::find_byte(list.begin(), list.end(), '\n')), 70);
+}
+
 TEST_F(BufferTest, buffer_read) {
   TestRuntimeCtx::runtime()->block_on(
       [](xyco::net::TcpStream *client,
@@ -163,6 +204,113 @@ TEST_F(BufferTest, buffer_read) {
       }(client_.get(), server_.get()));
 }
 
+TEST_F(BufferTest, extend_buffer) {
+  TestRuntimeCtx::runtime()->block_on([](xyco::net::TcpStream *client, xyco::net::TcpStream *server)
+                                          -> xyco::runtime::Future<void> {
+    xyco::io::BufferReader<xyco::net::TcpStream, std::string> reader(server, 4);
+    *co_await xyco::io::WriteExt::write_all(*client, std::string_view("ab"));
+    auto [begin, end] = *co_await reader.fill_buffer();
+
+    CO_ASSERT_EQ(std::string(begin, end), "ab");
+
+    *co_await xyco::io::WriteExt::write_all(*client, std::string_view("cdef"));
+    std::tie(begin, end) = *co_await reader.extend_buffer();
+
+    CO_ASSERT_EQ(std::string(begin, end), "abcd");
+
+    // Compacts "bcd" to the front before reading behind it.
+    reader.consume(1);
+    std::tie(begin, end) = *co_await reader.extend_buffer();
+
+    CO_ASSERT_EQ(std::string(begin, end), "bcde");
+    CO_ASSERT_EQ((co_await reader.extend_buffer()).error().errno_, ENOBUFS);
+    CO_ASSERT_EQ(reader.capacity(), 4U);
+  }(client_.get(), server_.get()));
+}
+
+// Serves `size_` bytes without any IO and records the advice it gets.
+class AdvisedReader {
+ public:
+  auto read(std::string::iterator begin,
+            std::string::iterator end) -> xyco::runtime::Future<xyco::utils::Result<uintptr_t>> {
+    auto len = std::min(static_cast<size_t>(std::distance(begin, end)), size_ - pos_);
+    std::fill_n(begin, len, 'a');
+    pos_ += len;
+    co_return len;
+  }
+
+  auto advise(xyco::io::Advice advice,
+              int64_t offset,
+              int64_t len) -> xyco::runtime::Future<xyco::utils::Result<void>> {
+    advices_.emplace_back(advice, offset, len);
+    co_return {};
+  }
+
+  explicit AdvisedReader(size_t size) : size_(size) {}
+
+  std::vector<std::tuple<xyco::io::Advice, int64_t, int64_t>> advices_;
+
+ private:
+  size_t size_;
+  size_t pos_{};
+};
+
+TEST(BufferReadStreamingTest, follow_streaming) {
+  TestRuntimeCtx::runtime()->block_on([]() -> xyco::runtime::Future<void> {
+    constexpr size_t size = 4 * 1024 * 1024;
+    auto inner_reader = AdvisedReader(size);
+    auto reader = xyco::io::BufferReader<AdvisedReader, std::string>(&inner_reader);
+    reader.drop_behind(true);
+    auto content =
+        co_await xyco::io::BufferReadExt::read_to_end<decltype(reader), std::string>(reader);
+
+    CO_ASSERT_EQ(content->size(), size);
+    CO_ASSERT_EQ(reader.capacity(), 128 * 1024U);
+    CO_ASSERT_EQ(inner_reader.advices_.empty(), false);
+    CO_ASSERT_EQ(std::get<0>(inner_reader.advices_.front()) == xyco::io::Advice::Sequential, true);
+
+    // The pages behind the scan are dropped in ranges following each other.
+    int64_t dropped = 0;
+    for (auto [advice, offset, len] : inner_reader.advices_ | std::views::drop(1)) {
+      CO_ASSERT_EQ(advice == xyco::io::Advice::DontNeed, true);
+      CO_ASSERT_EQ(offset, dropped);
+      dropped += len;
+    }
+
+    CO_ASSERT_EQ(dropped >= 1024 * 1024, true);
+  }());
+}
+
+TEST_F(BufferTest, buffer_write) {
+  TestRuntimeCtx::runtime()->block_on([](xyco::net::TcpStream *client, xyco::net::TcpStream *server)
+                                          -> xyco::runtime::Future<void> {
+    xyco::io::BufferWriter<xyco::net::TcpStream, std::string> writer(client, 4);
+    *co_await xyco::io::WriteExt::write_all(writer, std::string_view("ab"));
+    *co_await xyco::io::WriteExt::write_all(writer, std::string_view("cd"));
+
+    CO_ASSERT_EQ(writer.buffered(), 4U);
+
+    // Writes out "abcd" to make room.
+    *co_await xyco::io::WriteExt::write_all(writer, std::string_view("e"));
+
+    CO_ASSERT_EQ(writer.buffered(), 1U);
+
+    // Writes out "e", then passes the large write through.
+    *co_await xyco::io::WriteExt::write_all(writer, std::string_view("fghi"));
+
+    CO_ASSERT_EQ(writer.buffered(), 0U);
+
+    *co_await xyco::io::WriteExt::write_all(writer, std::string_view("j"));
+    *co_await writer.shutdown(xyco::io::Shutdown::All);
+
+    xyco::io::BufferReader<xyco::net::TcpStream, std::string> reader(server);
+    auto readed =
+        *co_await xyco::io::BufferReadExt::read_to_end<decltype(reader), std::string>(reader);
+
+    CO_ASSERT_EQ(readed, "abcdefghij");
+  }(client_.get(), server_.get()));
+}
+
 TEST_F(BufferTest, c_array_buffer) {
   TestRuntimeCtx::runtime()->block_on([](xyco::net::TcpStream *client, xyco::net::TcpStream *server)
                                           -> xyco::runtime::Future<void> {
@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+
+#include <coroutine>
+#include <string>
+#include <string_view>
+
+import xyco.test.utils;
+import xyco.io;
+import xyco.sync;
+
+TEST(BytesTest, concept) {
+  static_assert(xyco::io::Buffer<xyco::io::Bytes>);
+  static_assert(xyco::io::DynamicBuffer<xyco::io::BytesMut>);
+}
+
+TEST(BytesTest, slice) {
+  auto bytes = xyco::io::Bytes::copy_from(std::string_view("abcdef"));
+  auto slice = bytes.slice(1, 4);
+
+  ASSERT_EQ(std::string(slice.begin(), slice.end()), "bcd");
+  ASSERT_EQ(slice.data(), bytes.data() + 1);
+  ASSERT_EQ(bytes.slice(4, 10).size(), 2U);
+
+  auto front = bytes.split_to(2);
+
+  ASSERT_EQ(std::string(front.begin(), front.end()), "ab");
+  ASSERT_EQ(std::string(bytes.begin(), bytes.end()), "cdef");
+}
+
+TEST(BytesTest, split_and_freeze) {
+  auto bytes = xyco::io::BytesMut::with_capacity(8);
+  bytes.append(std::string_view("abcd"));
+  const auto *data = bytes.data();
+  auto front = bytes.split_to(3);
+
+  ASSERT_EQ(front.capacity(), 3U);
+  ASSERT_EQ(bytes.capacity(), 5U);
+
+  bytes.append(std::string_view("ef"));
+  auto frozen = std::move(front).freeze();
+
+  ASSERT_EQ(frozen.data(), data);
+  ASSERT_EQ(std::string(frozen.begin(), frozen.end()), "abc");
+  ASSERT_EQ(std::string(bytes.begin(), bytes.end()), "def");
+}
+
+TEST(BytesTest, resize) {
+  auto bytes = xyco::io::BytesMut(2, 'a');
+  bytes.resize(4, 'b');
+
+  ASSERT_EQ(std::string(bytes.begin(), bytes.end()), "aabb");
+  ASSERT_EQ(bytes.capacity(), 4U);
+
+  bytes.resize(1);
+
+  ASSERT_EQ(std::string(bytes.begin(), bytes.end()), "a");
+  ASSERT_EQ(bytes.capacity(), 4U);
+}
+
+TEST(BytesTest, send_without_copy) {
+  TestRuntimeCtx::runtime()->block_on([]() -> xyco::runtime::Future<void> {
+    auto bytes = xyco::io::BytesMut::with_capacity(4);
+    bytes.append(std::string_view("ab"));
+    const auto *data = bytes.data();
+    auto [sender, receiver] = xyco::sync::oneshot::channel<xyco::io::Bytes>();
+    co_await sender.send(bytes.split().freeze());
+    auto received = *co_await receiver.receive();
+
+    CO_ASSERT_EQ(received.data(), data);
+    CO_ASSERT_EQ(std::string(received.begin(), received.end()), "ab");
+  }());
+}
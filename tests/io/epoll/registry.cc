@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <chrono>
+#include <memory>
+
+import xyco.runtime_core;
+import xyco.io;
+import xyco.libc;
+
+class EdgeRegistryTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_EQ(xyco::libc::pipe2(pipe_.data(), 0), 0);
+    event_ = std::make_shared<xyco::runtime::Event>(
+        xyco::runtime::Event{.extra_ = std::make_unique<xyco::io::epoll::IoExtra>(
+                                 xyco::io::epoll::IoExtra::Interest::Read, pipe_[0])});
+  }
+
+  void TearDown() override {
+    xyco::libc::close(pipe_[0]);
+    xyco::libc::close(pipe_[1]);
+  }
+
+  auto select() -> xyco::runtime::Events {
+    xyco::runtime::Events events;
+    EXPECT_TRUE(registry_.select(events, std::chrono::milliseconds(1)));
+    return events;
+  }
+
+  auto write_pipe() -> void { ASSERT_EQ(xyco::libc::write(pipe_[1], "x", 1), 1); }
+
+  xyco::io::epoll::IoRegistryImpl registry_{4, xyco::io::epoll::IoRegistryImpl::Mode::Edge};
+  std::array<int, 2> pipe_{};
+  std::shared_ptr<xyco::runtime::Event> event_;
+};
+
+TEST_F(EdgeRegistryTest, wake_on_edge) {
+  ASSERT_TRUE(registry_.Register(event_));
+  ASSERT_TRUE(select().empty());
+
+  write_pipe();
+  auto events = select();
+  ASSERT_EQ(events.size(), 1);
+  ASSERT_EQ(events[0], event_);
+
+  // No new edge, so the event keeps waiting.
+  ASSERT_TRUE(registry_.reregister(event_));
+  ASSERT_TRUE(select().empty());
+
+  ASSERT_TRUE(registry_.deregister(event_));
+}
+
+TEST_F(EdgeRegistryTest, consume_cached_readiness) {
+  ASSERT_TRUE(registry_.Register(event_));
+  write_pipe();
+  ASSERT_EQ(select().size(), 1);
+
+  // The edge arrives while nothing waits on the event and is cached until the
+  // next wait.
+  write_pipe();
+  ASSERT_TRUE(select().empty());
+  ASSERT_TRUE(registry_.reregister(event_));
+  auto events = select();
+  ASSERT_EQ(events.size(), 1);
+  ASSERT_EQ(events[0], event_);
+
+  ASSERT_TRUE(registry_.deregister(event_));
+}
+
+TEST_F(EdgeRegistryTest, hang_up_is_consumed) {
+  ASSERT_TRUE(registry_.Register(event_));
+  xyco::libc::close(pipe_[1]);
+  pipe_[1] = -1;
+  ASSERT_EQ(select().size(), 1);
+
+  // The hang up is reported once, so the next wait parks until a new edge.
+  ASSERT_TRUE(registry_.reregister(event_));
+  ASSERT_TRUE(select().empty());
+
+  ASSERT_TRUE(registry_.deregister(event_));
+}
+
+TEST(IoRegistryTest, watch) {
+  std::array<int, 2> pipe{};
+  ASSERT_EQ(xyco::libc::pipe2(pipe.data(), 0), 0);
+  xyco::io::epoll::IoRegistryImpl registry(4);
+  ASSERT_TRUE(registry.watch(pipe[0]));
+  ASSERT_TRUE(registry.watch(pipe[0]));
+
+  // A readable watched fd ends the wait but yields no event.
+  ASSERT_EQ(xyco::libc::write(pipe[1], "x", 1), 1);
+  xyco::runtime::Events events;
+  ASSERT_TRUE(registry.select(events, std::chrono::milliseconds(1)));
+  ASSERT_TRUE(events.empty());
+
+  xyco::libc::close(pipe[0]);
+  xyco::libc::close(pipe[1]);
+}
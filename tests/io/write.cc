@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <coroutine>
+#include <cstdint>
+#include <expected>
+#include <span>
+#include <string>
+#include <vector>
+
+import xyco.test.utils;
+import xyco.error;
+import xyco.libc;
+import xyco.io;
+
+// Takes at most `max_write_` bytes per call, and fails every other call with
+// `EAGAIN`, like a socket whose buffer is nearly full.
+class ShortWriter {
+ public:
+  auto write_vectored(std::span<const xyco::libc::iovec> iovecs)
+      -> xyco::runtime::Future<xyco::utils::Result<uintptr_t>> {
+    if ((calls_++ % 2) == 1) {
+      co_return std::unexpected(xyco::utils::Error{.errno_ = EAGAIN, .info_ = ""});
+    }
+    size_t written = 0;
+    for (const auto &iovec : iovecs) {
+      auto len = std::min(iovec.iov_len, max_write_ - written);
+      content_.append(static_cast<const char *>(iovec.iov_base), len);
+      written += len;
+    }
+    co_return written;
+  }
+
+  explicit ShortWriter(size_t max_write) : max_write_(max_write) {}
+
+  std::string content_;
+
+ private:
+  size_t max_write_;
+  int calls_{};
+};
+
+TEST(WriteTest, write_all_vectored_partial) {
+  TestRuntimeCtx::runtime()->block_on([]() -> xyco::runtime::Future<void> {
+    std::string first = "abc";
+    std::string second = "defg";
+    std::string third = "hi";
+    std::vector<xyco::libc::iovec> iovecs{{.iov_base = first.data(), .iov_len = first.size()},
+                                          {.iov_base = second.data(), .iov_len = second.size()},
+                                          {.iov_base = third.data(), .iov_len = third.size()}};
+    // Writes "abc", then "def" ending inside the second buffer, then "ghi"
+    // crossing into the third one.
+    auto writer = ShortWriter(3);
+    auto write_result = co_await xyco::io::WriteExt::write_all_vectored(writer, iovecs);
+
+    CO_ASSERT_EQ(write_result.has_value(), true);
+    CO_ASSERT_EQ(writer.content_, "abcdefghi");
+    // The caller's iovecs are left as they were.
+    CO_ASSERT_EQ(iovecs[1].iov_base, static_cast<void *>(second.data()));
+    CO_ASSERT_EQ(iovecs[1].iov_len, second.size());
+  }());
+}
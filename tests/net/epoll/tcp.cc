@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <coroutine>
+#include <string>
+#include <thread>
+#include <vector>
+
+import xyco.test.utils;
+import xyco.runtime;
+import xyco.task;
+import xyco.net;
+import xyco.io;
+
+// Answers each byte from the server with the same byte.
+auto echo_client(uint16_t port, int rounds) -> xyco::runtime::Future<void> {
+  auto client = *co_await xyco::net::epoll::TcpStream::connect(
+      xyco::net::SocketAddr::new_v4("127.0.0.1", port));
+  auto buffer = std::string(1, 0);
+  for (int i = 0; i < rounds; i++) {
+    *co_await client.read(buffer.begin(), buffer.end());
+    *co_await client.write(buffer.begin(), buffer.end());
+  }
+}
+
+TEST(EpollTcpTest, TcpListener_accept_on_local_registry) {
+  // Only per-worker epoll instances, without the shared `epoll::IoRegistry`.
+  auto runtime = *xyco::runtime::Builder::new_multi_thread()
+                      .worker_threads(2)
+                      .registry<xyco::task::BlockingRegistry>(1)
+                      .registry<xyco::io::epoll::LocalIoRegistry>(4)
+                      .build();
+  runtime->block_on([](xyco::runtime::Runtime *runtime) -> xyco::runtime::Future<void> {
+    const uint16_t port = 8089;
+    const int rounds = 10;
+
+    auto owner = std::this_thread::get_id();
+    auto listener = co_await xyco::net::epoll::TcpListener::bind_per_worker(
+        xyco::net::SocketAddr::new_v4({}, port));
+
+    CO_ASSERT_EQ(listener.has_value(), true);
+
+    runtime->spawn(echo_client(port, rounds));
+    auto stream = std::move((*co_await listener->accept()).first);
+    auto buffer = std::string("a");
+    std::vector<std::thread::id> threads;
+    for (int i = 0; i < rounds; i++) {
+      *co_await stream.write(buffer.begin(), buffer.end());
+      *co_await stream.read(buffer.begin(), buffer.end());
+      threads.push_back(std::this_thread::get_id());
+    }
+
+    // Every read waiting for the echo resumes on the accepting worker.
+    CO_ASSERT_EQ(std::ranges::count(threads, owner), rounds);
+  }(runtime.get()));
+}
+
+TEST(EpollTcpTest, TcpListener_accept_batch) {
+  // The test runtime may use io_uring for sockets in the auto build.
+  auto runtime = *xyco::runtime::Builder::new_multi_thread()
+                      .worker_threads(1)
+                      .registry<xyco::task::BlockingRegistry>(1)
+                      .registry<xyco::io::epoll::IoRegistry>(4)
+                      .build();
+  runtime->block_on([]() -> xyco::runtime::Future<void> {
+    const uint16_t port = 8090;
+    constexpr size_t max_batch = 2;
+
+    auto listener =
+        *co_await xyco::net::epoll::TcpListener::bind(xyco::net::SocketAddr::new_v4({}, port));
+    // Connections are established in the backlog before they are accepted.
+    std::vector<xyco::net::epoll::TcpStream> clients;
+    for (int i = 0; i < 3; i++) {
+      clients.push_back(*co_await xyco::net::epoll::TcpStream::connect(
+          xyco::net::SocketAddr::new_v4("127.0.0.1", port)));
+    }
+    auto first_batch = *co_await listener.accept_batch(max_batch);
+    auto second_batch = *co_await listener.accept_batch(max_batch);
+
+    CO_ASSERT_EQ(first_batch.size(), max_batch);
+    CO_ASSERT_EQ(second_batch.size(), 1U);
+  }());
+}
+
+auto write_byte(xyco::net::epoll::TcpStream *stream) -> xyco::runtime::Future<void> {
+  auto buffer = std::string("b");
+  *co_await stream->write(buffer.begin(), buffer.end());
+}
+
+TEST(EpollTcpTest, fast_path_counter) {
+  // Only the in-place worker, which owns the counts and runs tasks in the order
+  // they are queued.
+  auto runtime = *xyco::runtime::Builder::new_multi_thread()
+                      .worker_threads(0)
+                      .registry<xyco::task::BlockingRegistry>(1)
+                      .registry<xyco::io::epoll::IoRegistry>(4)
+                      .build();
+  runtime->block_on([](xyco::runtime::Runtime *runtime) -> xyco::runtime::Future<void> {
+    const uint16_t port = 8091;
+
+    auto listener =
+        *co_await xyco::net::epoll::TcpListener::bind(xyco::net::SocketAddr::new_v4({}, port));
+    auto client = *co_await xyco::net::epoll::TcpStream::connect(
+        xyco::net::SocketAddr::new_v4("127.0.0.1", port));
+    auto server = std::move((*co_await listener.accept()).first);
+    auto buffer = std::string("a");
+
+    *co_await client.write(buffer.begin(), buffer.end());
+    auto hits = xyco::io::epoll::FastPathCounter::hits();
+    *co_await server.read(buffer.begin(), buffer.end());
+
+    // The byte is already buffered, so the first `read` completes it.
+    CO_ASSERT_EQ(xyco::io::epoll::FastPathCounter::hits(), hits + 1);
+
+    // The write only runs once the read waits on the empty socket.
+    auto misses = xyco::io::epoll::FastPathCounter::misses();
+    runtime->spawn(write_byte(&client));
+    *co_await server.read(buffer.begin(), buffer.end());
+
+    CO_ASSERT_EQ(xyco::io::epoll::FastPathCounter::misses(), misses + 1);
+    CO_ASSERT_EQ(buffer, "b");
+  }(runtime.get()));
+}
+
+TEST(EpollTcpTest, TcpStream_rw_on_edge_registry) {
+  auto runtime = *xyco::runtime::Builder::new_multi_thread()
+                      .worker_threads(1)
+                      .registry<xyco::task::BlockingRegistry>(1)
+                      .registry<xyco::io::epoll::IoRegistry>(
+                          4, xyco::io::epoll::IoRegistryImpl::Mode::Edge)
+                      .build();
+  runtime->block_on([]() -> xyco::runtime::Future<void> {
+    const uint16_t port = 8093;
+
+    auto listener =
+        *co_await xyco::net::epoll::TcpListener::bind(xyco::net::SocketAddr::new_v4({}, port));
+    auto client = *co_await xyco::net::epoll::TcpStream::connect(
+        xyco::net::SocketAddr::new_v4("127.0.0.1", port));
+    auto server = std::move((*co_await listener.accept()).first);
+
+    auto ping = std::string("ping");
+    auto buffer = std::string(ping.size(), 0);
+    *co_await client.write(ping.begin(), ping.end());
+    CO_ASSERT_EQ(*co_await server.read(buffer.begin(), buffer.end()), ping.size());
+    CO_ASSERT_EQ(buffer, ping);
+
+    // The half close surfaces as EOF on every read instead of a sticky error, and
+    // the other direction keeps working.
+    *co_await client.shutdown(xyco::io::Shutdown::Write);
+    CO_ASSERT_EQ(*co_await server.read(buffer.begin(), buffer.end()), 0U);
+    CO_ASSERT_EQ(*co_await server.read(buffer.begin(), buffer.end()), 0U);
+
+    auto pong = std::string("pong");
+    *co_await server.write(pong.begin(), pong.end());
+    CO_ASSERT_EQ(*co_await client.read(buffer.begin(), buffer.end()), pong.size());
+    CO_ASSERT_EQ(buffer, pong);
+  }());
+}
@@ -1,6 +1,9 @@
 #include <gtest/gtest.h>
 #include <netinet/in.h>
 
+#include <cerrno>
+#include <chrono>
+
 import xyco.test.utils;
 import xyco.net;
 import xyco.libc;
@@ -44,4 +47,17 @@ TEST(SocketTest, is_v4) {
 
   auto sock_addrv6 = xyco::net::SocketAddr::new_v6(xyco::net::Ipv6Addr("::1"), http_port);
   ASSERT_EQ(sock_addrv6.is_v4(), false);
-}
\ No newline at end of file
+}
+TEST(SocketTest, set_busy_poll) {
+  xyco::net::Socket socket(
+      xyco::libc::socket(xyco::libc::K_AF_INET, xyco::libc::K_SOCK_STREAM, 0));
+  ASSERT_NE(socket.into_c_fd(), -1);
+
+  // Enabling busy polling beyond the sysctl default needs `CAP_NET_ADMIN`.
+  auto enable_result = socket.set_busy_poll(std::chrono::microseconds(50));
+  if (!enable_result) {
+    ASSERT_EQ(enable_result.error().errno_, EPERM);
+  }
+
+  ASSERT_TRUE(socket.set_busy_poll(std::chrono::microseconds(0)));
+}
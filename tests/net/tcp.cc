@@ -1,12 +1,22 @@
 #include <gtest/gtest.h>
 
+#include <array>
+#include <atomic>
 #include <coroutine>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include "spdlog/spdlog.h"
 
 import xyco.logging;
 import xyco.test.utils;
+import xyco.runtime;
+import xyco.task;
 import xyco.net;
+import xyco.fs;
 import xyco.libc;
 import xyco.io;
 
@@ -84,6 +94,100 @@ TEST(TcpTest, TcpListener_bind) {
   }());
 }
 
+TEST(TcpTest, TcpListener_bind_per_worker) {
+  TestRuntimeCtx::runtime()->block_on([]() -> xyco::runtime::Future<void> {
+    const uint16_t port = 8087;
+
+    auto result1 =
+        co_await xyco::net::TcpListener::bind_per_worker(xyco::net::SocketAddr::new_v4({}, port));
+    auto result2 =
+        co_await xyco::net::TcpListener::bind_per_worker(xyco::net::SocketAddr::new_v4({}, port));
+
+    CO_ASSERT_EQ(result1.has_value(), true);
+    CO_ASSERT_EQ(result2.has_value(), true);
+  }());
+}
+
+// Listeners bound by `accept_until_quit` on every worker.
+struct PerWorkerListeners {
+  static constexpr int WORKERS = 2;
+
+  std::atomic_int bound_;
+  std::atomic_int stopped_;
+  std::mutex mutex_;
+  std::set<std::thread::id> threads_;
+  std::array<std::atomic_int, WORKERS> accepted_{};
+};
+
+// Counts connections on its own listener until a client sends 'q'.
+auto accept_until_quit(uint16_t port, PerWorkerListeners *listeners)
+    -> xyco::runtime::Future<void> {
+  int index = 0;
+  {
+    std::scoped_lock<std::mutex> lock_guard(listeners->mutex_);
+    index = static_cast<int>(listeners->threads_.size());
+    listeners->threads_.insert(std::this_thread::get_id());
+  }
+  auto listener =
+      *co_await xyco::net::TcpListener::bind_per_worker(xyco::net::SocketAddr::new_v4({}, port));
+  listeners->bound_++;
+  while (true) {
+    auto [stream, addr] = *co_await listener.accept();
+    auto buffer = std::string(1, 0);
+    *co_await xyco::io::ReadExt::read(stream, buffer);
+    if (buffer == "q") {
+      break;
+    }
+    listeners->accepted_.at(index)++;
+  }
+  listeners->stopped_++;
+}
+
+TEST(TcpTest, TcpListener_bind_per_worker_spread) {
+  constexpr int connections = 32;
+  auto runtime = *xyco::runtime::Builder::new_multi_thread()
+                      .worker_threads(PerWorkerListeners::WORKERS)
+                      .registry<xyco::task::BlockingRegistry>(1)
+                      .registry<xyco::io::LocalIoRegistry>(4)
+                      .build();
+  PerWorkerListeners listeners;
+  const uint16_t port = 8092;
+  runtime->spawn_on_each_worker([&]() { return accept_until_quit(port, &listeners); });
+  while (listeners.bound_.load() != PerWorkerListeners::WORKERS) {
+    std::this_thread::yield();
+  }
+
+  runtime->block_on([](uint16_t port,
+                      PerWorkerListeners *listeners) -> xyco::runtime::Future<void> {
+    auto addr = xyco::net::SocketAddr::new_v4("127.0.0.1", port);
+    for (int i = 0; i < connections; i++) {
+      auto client = *co_await xyco::net::TcpStream::connect(addr);
+      *co_await xyco::io::WriteExt::write_all(client, std::string_view("c"));
+    }
+    // Each 'q' reaches one of the listeners still open, so repeat it until all
+    // of them have stopped.
+    while (listeners->stopped_.load() != PerWorkerListeners::WORKERS) {
+      auto client = co_await xyco::net::TcpStream::connect(addr);
+      if (!client) {
+        continue;
+      }
+      *co_await xyco::io::WriteExt::write_all(*client, std::string_view("q"));
+      // Waits for the listener to drop the connection before checking again.
+      auto buffer = std::string(1, 0);
+      [[maybe_unused]] auto read_result = co_await xyco::io::ReadExt::read(*client, buffer);
+    }
+  }(port, &listeners));
+
+  // One listener per worker, and the kernel spreads connections over them.
+  ASSERT_EQ(listeners.threads_.size(), static_cast<size_t>(PerWorkerListeners::WORKERS));
+  int accepted = 0;
+  for (auto &count : listeners.accepted_) {
+    ASSERT_GT(count.load(), 0);
+    accepted += count.load();
+  }
+  ASSERT_EQ(accepted, connections);
+}
+
 TEST(TcpTest, connect_to_closed_server) {
   TestRuntimeCtx::runtime()->block_on([]() -> xyco::runtime::Future<void> {
     const char *server_ip = "127.0.0.1";
@@ -190,6 +294,36 @@ TEST_F(WithServerTest, TcpListener_accept) {
   }());
 }
 
+TEST_F(WithServerTest, TcpListener_accept_batch) {
+  TestRuntimeCtx::runtime()->block_on([]() -> xyco::runtime::Future<void> {
+    constexpr size_t max_batch = 2;
+
+    std::vector<xyco::net::TcpStream> clients;
+    for (int i = 0; i < 3; i++) {
+      clients.push_back(
+          *co_await xyco::net::TcpStream::connect(xyco::net::SocketAddr::new_v4(ip_, port_)));
+    }
+    size_t accepted = 0;
+    while (accepted < clients.size()) {
+      auto batch = *co_await listener_->accept_batch(max_batch);
+
+      CO_ASSERT_EQ(batch.empty(), false);
+      CO_ASSERT_EQ(batch.size() <= max_batch, true);
+      accepted += batch.size();
+    }
+
+    CO_ASSERT_EQ(accepted, clients.size());
+  }());
+}
+
+TEST_F(WithServerTest, TcpListener_accept_empty_batch) {
+  TestRuntimeCtx::runtime()->block_on([]() -> xyco::runtime::Future<void> {
+    auto batch = co_await listener_->accept_batch(0);
+
+    CO_ASSERT_EQ(batch.error().errno_, EINVAL);
+  }());
+}
+
 TEST_F(WithServerTest, TcpStream_rw_loop) {
   constexpr int ITERATION_TIMES = 100000;
 
@@ -238,3 +372,57 @@ TEST_F(WithServerTest, TcpStream_rw_twice) {
     CO_ASSERT_EQ(r_nbytes, r_buf.size());
   }());
 }
+
+TEST_F(WithServerTest, TcpStream_rw_vectored) {
+  TestRuntimeCtx::runtime()->block_on([]() -> xyco::runtime::Future<void> {
+    auto client =
+        *co_await xyco::net::TcpStream::connect(xyco::net::SocketAddr::new_v4(ip_, port_));
+    auto [server_stream, addr] = *co_await listener_->accept();
+
+    std::string header = "header";
+    std::string body = "body";
+    auto w_iovecs =
+        std::array{xyco::libc::iovec{.iov_base = header.data(), .iov_len = header.size()},
+                   xyco::libc::iovec{.iov_base = body.data(), .iov_len = body.size()}};
+    auto w_result = co_await xyco::io::WriteExt::write_all_vectored(client, w_iovecs);
+    CO_ASSERT_EQ(w_result.has_value(), true);
+
+    auto r_header = std::string(header.size(), 0);
+    auto r_body = std::string(body.size(), 0);
+    auto r_iovecs =
+        std::array{xyco::libc::iovec{.iov_base = r_header.data(), .iov_len = r_header.size()},
+                   xyco::libc::iovec{.iov_base = r_body.data(), .iov_len = r_body.size()}};
+    auto r_nbytes = *co_await server_stream.read_vectored(r_iovecs);
+
+    CO_ASSERT_EQ(r_nbytes, header.size() + body.size());
+    CO_ASSERT_EQ(r_header, header);
+    CO_ASSERT_EQ(r_body, body);
+  }());
+}
+
+TEST_F(WithServerTest, copy_file_to_stream) {
+  TestRuntimeCtx::runtime()->block_on([]() -> xyco::runtime::Future<void> {
+    const char *path = "test_copy_file_to_stream";
+
+    auto client =
+        *co_await xyco::net::TcpStream::connect(xyco::net::SocketAddr::new_v4(ip_, port_));
+    auto [server_stream, addr] = *co_await listener_->accept();
+
+    std::string content = "abcd";
+    {
+      auto file = *co_await xyco::fs::File::create(path);
+      *co_await file.write(content.begin(), content.end());
+    }
+    auto file = *co_await xyco::fs::File::open(path);
+    // Requests more bytes than the file has after `offset`.
+    auto copy_nbytes =
+        *co_await xyco::io::copy_file_to_stream(file, server_stream, 1, content.size());
+    auto r_buf = std::string(copy_nbytes, 0);
+    auto r_nbytes = *co_await xyco::io::ReadExt::read(client, r_buf);
+    *co_await xyco::fs::remove(path);
+
+    CO_ASSERT_EQ(copy_nbytes, content.size() - 1);
+    CO_ASSERT_EQ(r_nbytes, copy_nbytes);
+    CO_ASSERT_EQ(r_buf, content.substr(1));
+  }());
+}
@@ -1,8 +1,16 @@
 #include <gtest/gtest.h>
 
+#include <atomic>
 #include <coroutine>
+#include <mutex>
+#include <set>
+#include <thread>
 
 import xyco.test.utils;
+import xyco.runtime;
+import xyco.runtime_ctx;
+import xyco.sync;
+import xyco.task;
 
 TEST(RuntimeTest, block_on_void) {
   TestRuntimeCtx::runtime()->block_on([]() -> xyco::runtime::Future<void> { co_return; }());
@@ -13,3 +21,47 @@ TEST(RuntimeTest, block_on_with_return_value) {
       TestRuntimeCtx::runtime()->block_on([]() -> xyco::runtime::Future<int> { co_return 1; }());
   ASSERT_EQ(result, 1);
 }
+
+TEST(RuntimeTest, spawn_local) {
+  auto thread_id = TestRuntimeCtx::runtime()->block_on(
+      []() -> xyco::runtime::Future<std::thread::id> {
+        auto [sender, receiver] = xyco::sync::oneshot::channel<std::thread::id>();
+        xyco::runtime::RuntimeCtx::spawn_local([](auto sender) -> xyco::runtime::Future<void> {
+          *co_await sender.send(std::this_thread::get_id());
+        }(std::move(sender)));
+        co_return *co_await receiver.receive();
+      }());
+
+  // `block_on` runs on the in-place worker, which is the current thread.
+  ASSERT_EQ(thread_id, std::this_thread::get_id());
+}
+
+TEST(RuntimeTest, spawn_on_each_worker) {
+  constexpr uint16_t workers = 4;
+  auto runtime = *xyco::runtime::Builder::new_multi_thread()
+                      .worker_threads(workers)
+                      .registry<xyco::task::BlockingRegistry>(1)
+                      .build();
+  std::mutex mutex;
+  std::set<std::thread::id> threads;
+  std::atomic_int spawned = 0;
+  runtime->spawn_on_each_worker([&]() {
+    return [](std::mutex *mutex,
+              std::set<std::thread::id> *threads,
+              std::atomic_int *spawned) -> xyco::runtime::Future<void> {
+      {
+        std::scoped_lock<std::mutex> lock_guard(*mutex);
+        threads->insert(std::this_thread::get_id());
+      }
+      spawned->fetch_add(1);
+      co_return;
+    }(&mutex, &threads, &spawned);
+  });
+
+  while (spawned.load() != workers) {
+    std::this_thread::yield();
+  }
+  std::scoped_lock<std::mutex> lock_guard(mutex);
+  ASSERT_EQ(threads.size(), static_cast<size_t>(workers));
+  ASSERT_EQ(threads.contains(std::this_thread::get_id()), false);
+}
@@ -7,28 +7,62 @@ import xyco.runtime_core;
 import xyco.libc;
 import xyco.io;
 
-TEST(FmtTypeTest, IoExtra_Event) {
-  auto event = xyco::runtime::Event{.extra_ = std::make_unique<xyco::io::IoExtra>()};
-  auto *extra = dynamic_cast<xyco::io::IoExtra *>(event.extra_.get());
+TEST(FmtTypeTest, UringIoExtra_Event) {
+  auto event = xyco::runtime::Event{.extra_ = std::make_unique<xyco::io::uring::IoExtra>()};
+  auto *extra = dynamic_cast<xyco::io::uring::IoExtra *>(event.extra_.get());
 
   extra->fd_ = 1;
-  extra->args_ = xyco::io::IoExtra::Read{.len_ = 1, .offset_ = 0};
+  extra->args_ = xyco::io::uring::IoExtra::Read{.len_ = 1, .offset_ = 0};
   auto fmt_str = std::format("{}", *extra);
   ASSERT_EQ(fmt_str, "IoExtra{args_=Read{len_=1, offset_=0}, fd_=1, return_=0}");
 
   fmt_str = std::format("{}", event);
   ASSERT_EQ(fmt_str, "Event{extra_=IoExtra{args_=Read{len_=1, offset_=0}, fd_=1, return_=0}}");
 
-  extra->args_ = xyco::io::IoExtra::Write{.len_ = 1, .offset_ = 0};
+  extra->args_ = xyco::io::uring::IoExtra::Write{.len_ = 1, .offset_ = 0};
   fmt_str = std::format("{}", event);
   ASSERT_EQ(fmt_str,
             "Event{extra_=IoExtra{args_=Write{len_=1, offset_=0}, fd_=1, "
             "return_=0}}");
 
-  extra->args_ = xyco::io::IoExtra::Close{};
+  extra->args_ = xyco::io::uring::IoExtra::Readv{.nr_vecs_ = 2, .offset_ = 0};
+  fmt_str = std::format("{}", event);
+  ASSERT_EQ(fmt_str,
+            "Event{extra_=IoExtra{args_=Readv{nr_vecs_=2, offset_=0}, fd_=1, "
+            "return_=0}}");
+
+  extra->args_ = xyco::io::uring::IoExtra::Writev{.nr_vecs_ = 2, .offset_ = 0};
+  fmt_str = std::format("{}", event);
+  ASSERT_EQ(fmt_str,
+            "Event{extra_=IoExtra{args_=Writev{nr_vecs_=2, offset_=0}, fd_=1, "
+            "return_=0}}");
+
+  extra->args_ = xyco::io::uring::IoExtra::Splice{.fd_in_ = 2, .off_in_ = 0, .len_ = 1};
+  fmt_str = std::format("{}", event);
+  ASSERT_EQ(fmt_str,
+            "Event{extra_=IoExtra{args_=Splice{fd_in_=2, off_in_=0, off_out_=-1, len_=1}, fd_=1, "
+            "return_=0}}");
+
+  extra->args_ = xyco::io::uring::IoExtra::Close{};
   fmt_str = std::format("{}", event);
   ASSERT_EQ(fmt_str, "Event{extra_=IoExtra{args_=Close{}, fd_=1, return_=0}}");
 
+  extra->args_ = xyco::io::uring::IoExtra::Fsync{.datasync_ = true};
+  fmt_str = std::format("{}", event);
+  ASSERT_EQ(fmt_str, "Event{extra_=IoExtra{args_=Fsync{datasync_=true}, fd_=1, return_=0}}");
+
+  extra->args_ = xyco::io::uring::IoExtra::Fallocate{.mode_ = 1, .offset_ = 0, .len_ = 4096};
+  fmt_str = std::format("{}", event);
+  ASSERT_EQ(fmt_str,
+            "Event{extra_=IoExtra{args_=Fallocate{mode_=1, offset_=0, len_=4096}, fd_=1, "
+            "return_=0}}");
+
+  extra->args_ = xyco::io::uring::IoExtra::SyncFileRange{.offset_ = 0, .len_ = 4096, .flags_ = 2};
+  fmt_str = std::format("{}", event);
+  ASSERT_EQ(fmt_str,
+            "Event{extra_=IoExtra{args_=SyncFileRange{offset_=0, len_=4096, flags_=2}, fd_=1, "
+            "return_=0}}");
+
   constexpr auto port = 8888;
   xyco::libc::in_addr char_addr{};
   xyco::libc::sockaddr_in addr{};
@@ -39,7 +73,7 @@ TEST(FmtTypeTest, IoExtra_Event) {
   addr.sin_port = port;
   extra->args_ =
       // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
-      xyco::io::IoExtra::Accept{.addr_ = reinterpret_cast<xyco::libc::sockaddr *>(&addr),
+      xyco::io::uring::IoExtra::Accept{.addr_ = reinterpret_cast<xyco::libc::sockaddr *>(&addr),
                                 .addrlen_ = &len};
   fmt_str = std::format("{}", event);
   ASSERT_EQ(fmt_str,
@@ -52,26 +86,26 @@ TEST(FmtTypeTest, IoExtra_Event) {
   addr.sin_port = port;
   extra->args_ =
       // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
-      xyco::io::IoExtra::Connect{.addr_ = reinterpret_cast<xyco::libc::sockaddr *>(&addr),
+      xyco::io::uring::IoExtra::Connect{.addr_ = reinterpret_cast<xyco::libc::sockaddr *>(&addr),
                                  .addrlen_ = sizeof(addr)};
   fmt_str = std::format("{}", event);
   ASSERT_EQ(fmt_str,
             "Event{extra_=IoExtra{args_=Connect{addr_={127.0.0.1:8888}}, fd_=1, "
             "return_=0}}");
 
-  extra->args_ = xyco::io::IoExtra::Shutdown{.shutdown_ = xyco::io::Shutdown::Read};
+  extra->args_ = xyco::io::uring::IoExtra::Shutdown{.shutdown_ = xyco::io::Shutdown::Read};
   fmt_str = std::format("{}", event);
   ASSERT_EQ(fmt_str,
             "Event{extra_=IoExtra{args_=Shutdown{shutdown_=Shutdown{Read}}, "
             "fd_=1, return_=0}}");
 
-  extra->args_ = xyco::io::IoExtra::Shutdown{.shutdown_ = xyco::io::Shutdown::Write};
+  extra->args_ = xyco::io::uring::IoExtra::Shutdown{.shutdown_ = xyco::io::Shutdown::Write};
   fmt_str = std::format("{}", event);
   ASSERT_EQ(fmt_str,
             "Event{extra_=IoExtra{args_=Shutdown{shutdown_=Shutdown{Write}}, "
             "fd_=1, return_=0}}");
 
-  extra->args_ = xyco::io::IoExtra::Shutdown{.shutdown_ = xyco::io::Shutdown::All};
+  extra->args_ = xyco::io::uring::IoExtra::Shutdown{.shutdown_ = xyco::io::Shutdown::All};
   fmt_str = std::format("{}", event);
   ASSERT_EQ(fmt_str,
             "Event{extra_=IoExtra{args_=Shutdown{shutdown_=Shutdown{All}}, "